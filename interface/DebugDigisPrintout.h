@@ -4,6 +4,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 #include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
 
 namespace rpcrawtodigi {
@@ -18,7 +19,8 @@ namespace rpcrawtodigi {
          if (this->det < o.det) return true;
          if (this->det > o.det) return false; 
          if (this->strip < o.strip) return true;
-         return false;
+         if (this->strip > o.strip) return false;
+         return this->bx < o.bx;
        }
     };
 
@@ -41,11 +43,11 @@ namespace rpcrawtodigi {
           nDigisAll++;
           const RPCDigi & digi = (*id);
           MyDigi myDigi = { rawDetId, digi.strip(), digi.bx() };
-          if (myDigis.end() == std::find(myDigis.begin(), myDigis.end(), myDigi)) 
-              myDigis.push_back(myDigi);
+          myDigis.push_back(myDigi);
         } 
       }
       std::sort(myDigis.begin(),myDigis.end());
+      myDigis.erase(std::unique(myDigis.begin(),myDigis.end()), myDigis.end());
       str << " dets: "<<nDet<<" allDigis: "<<nDigisAll<<" unigueDigis: "<<myDigis.size()<<std::endl;
       for (std::vector<MyDigi>::const_iterator it = myDigis.begin(); it != myDigis.end(); ++it)
            str << "debugDIGI: "<< it->det<<", "<<it->strip<<", "<<it->bx<<std::endl;
@@ -8,20 +8,38 @@
 #include <vector>
 
 namespace rpcrawtodigi {
+
+/** Records are kept as raw 16 bit data, with errors in a small inline
+ *  buffer, so that the class is trivially copyable and never allocates.
+ *  Errors beyond the buffer are only counted.
+ */
 class EventRecords {
 public:
 
+  static const int nInlineErrors = 4;
+
   EventRecords(int triggerbx=0) 
     : theTriggerBX(triggerbx), 
-      theValidBX(false), theValidLN(false), theValidCD(false)
+      theValidBX(false), theValidLN(false), theValidCD(false),
+      theRecordBX(0), theRecordSLD(0), theRecordCD(0),
+      theNErrors(0), theErrorOverflow(0)
   {}
 
   EventRecords(int bx, const RecordBX & bxr, const RecordSLD & tbr, const RecordCD & lbr)
     : theTriggerBX(bx),
       theValidBX(true), theValidLN(true), theValidCD(true),
-      theRecordBX(bxr), theRecordSLD(tbr), theRecordCD(lbr)
+      theRecordBX(bxr.data()), theRecordSLD(tbr.data()), theRecordCD(lbr.data()),
+      theNErrors(0), theErrorOverflow(0)
   {}
 
+  /// start new FED payload
+  void reset(int triggerbx) {
+    theTriggerBX = triggerbx;
+    theValidBX = theValidLN = theValidCD = false;
+    theNErrors = 0;
+    theErrorOverflow = 0;
+  }
+
   void add(const DataRecord & record);
 
   int triggerBx() const { return theTriggerBX;}
@@ -30,14 +48,21 @@ public:
 
   bool complete() const { return theValidBX && theValidLN && theValidCD; }
 
-  bool hasErrors() const { return (theErrors.size()>0); }
+  bool hasErrors() const { return (theNErrors>0); }
 
   bool samePartition(const EventRecords & r) const;
 
-  const RecordBX & recordBX() const { return theRecordBX; }
-  const RecordSLD & recordSLD() const { return theRecordSLD; }
-  const RecordCD & recordCD() const { return theRecordCD; }
-  const std::vector<DataRecord> & errors() const { return theErrors; }
+  RecordBX recordBX() const { return RecordBX(DataRecord(theRecordBX)); }
+  RecordSLD recordSLD() const { return RecordSLD(DataRecord(theRecordSLD)); }
+  RecordCD recordCD() const { return RecordCD(DataRecord(theRecordCD)); }
+
+  /// errors since last StartOfBXData, at most nInlineErrors
+  std::vector<DataRecord> errors() const {
+    return std::vector<DataRecord>(theErrors, theErrors+theNErrors);
+  }
+
+  /// errors not stored because the inline buffer was full
+  unsigned int errorOverflow() const { return theErrorOverflow; }
 
   static std::vector<EventRecords> mergeRecords(const std::vector<EventRecords> & r); 
 
@@ -46,10 +71,12 @@ public:
 private:
   int theTriggerBX;
   bool theValidBX, theValidLN, theValidCD; 
-  RecordBX theRecordBX; 
-  RecordSLD theRecordSLD;
-  RecordCD theRecordCD;
-  std::vector<DataRecord> theErrors;
+  DataRecord::Data theRecordBX; 
+  DataRecord::Data theRecordSLD;
+  DataRecord::Data theRecordCD;
+  DataRecord::Data theErrors[nInlineErrors];
+  unsigned short theNErrors;
+  unsigned int theErrorOverflow;
 };
 }
 #endif
@@ -0,0 +1,24 @@
+#ifndef EventFilter_RPCRawToDigi_FedCrc_H
+#define EventFilter_RPCRawToDigi_FedCrc_H
+
+/** \class rpcrawtodigi::FedCrc
+ *  CRC-16 of the FED payload as defined for the slink trailer
+ *  (polynomial 0x8005, initial value 0xFFFF, bytes of each 64 bit word
+ *  taken from the most significant one). The CRC field of the trailer is
+ *  treated as zero. Table driven, one 64 bit word per step (slice-by-8).
+ */
+
+#include <stdint.h>
+
+namespace rpcrawtodigi {
+class FedCrc {
+public:
+  /// CRC of nWords 64 bit words starting at data, including header and trailer
+  static uint16_t compute(const uint64_t * data, unsigned int nWords);
+
+  /// CRC field (bits 16-31) of the last trailer word
+  static const uint64_t trailerCrcMask = 0xFFFF0000ULL;
+  static const int trailerCrcShift = 16;
+};
+}
+#endif
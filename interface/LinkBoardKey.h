@@ -0,0 +1,29 @@
+#ifndef EventFilter_RPCRawToDigi_LinkBoardKey_H
+#define EventFilter_RPCRawToDigi_LinkBoardKey_H
+
+/** Packed 32 bit key of the LinkBoard electronic index, ordered as
+ *  LinkBoardElectronicIndex (dcc, rmb, link, lb). Used by the cabling
+ *  image and by the synchro histogram product.
+ */
+
+#include "CondFormats/RPCObjects/interface/LinkBoardElectronicIndex.h"
+#include <stdint.h>
+
+namespace rpcrawtodigi {
+
+inline uint32_t linkBoardKey(const LinkBoardElectronicIndex & ele) {
+  return (uint32_t(ele.dccId) << 16) | (uint32_t(ele.dccInputChannelNum) << 8)
+       | (uint32_t(ele.tbLinkInputNum) << 2) | uint32_t(ele.lbNumInLink);
+}
+
+inline LinkBoardElectronicIndex linkBoardIndex(uint32_t key) {
+  LinkBoardElectronicIndex ele;
+  ele.dccId              = key >> 16;
+  ele.dccInputChannelNum = (key >> 8) & 0xFF;
+  ele.tbLinkInputNum     = (key >> 2) & 0x3F;
+  ele.lbNumInLink        = key & 0x3;
+  return ele;
+}
+
+}
+#endif
@@ -0,0 +1,54 @@
+#ifndef EventFilter_RPCRawToDigi_LinkHit_H
+#define EventFilter_RPCRawToDigi_LinkHit_H
+
+/** \class rpcrawtodigi::LinkHit
+ *  Cabling independent content of one complete CD record: electronic
+ *  location, partition data, end of data bit and data to trigger delay. Stored by the
+ *  unpacker before any mapping, so that digis can be re-made with another
+ *  cabling without decoding raw data again (see RPCLinkHitsToDigiModule).
+ */
+
+#include "EventFilter/RPCRawToDigi/interface/EventRecords.h"
+#include "CondFormats/RPCObjects/interface/LinkBoardElectronicIndex.h"
+#include <vector>
+#include <stdint.h>
+
+namespace rpcrawtodigi {
+struct LinkHit {
+
+  LinkHit() : dccId(0), rmb(0), tbLink(0), lbInLink(0), partition(0), data(0), eod(0), delay(0) {}
+
+  LinkHit(int fedId, const EventRecords & event)
+    : dccId(fedId),
+      rmb(event.recordSLD().rmb()),
+      tbLink(event.recordSLD().tbLinkInputNumber()),
+      lbInLink(event.recordCD().lbInLink()),
+      partition(event.recordCD().partitionNumber()),
+      data(event.recordCD().partitionData()),
+      eod(event.recordCD().eod()),
+      delay(event.dataToTriggerDelay())
+  {}
+
+  LinkBoardElectronicIndex electronicIndex() const {
+    LinkBoardElectronicIndex ele;
+    ele.dccId = dccId;
+    ele.dccInputChannelNum = rmb;
+    ele.tbLinkInputNum = tbLink;
+    ele.lbNumInLink = lbInLink;
+    return ele;
+  }
+
+  uint16_t dccId;
+  uint8_t rmb;
+  uint8_t tbLink;
+  uint8_t lbInLink;
+  uint8_t partition;
+  uint8_t data;
+  uint8_t eod;
+  int16_t delay;
+};
+}
+
+typedef std::vector<rpcrawtodigi::LinkHit> RPCLinkHitCollection;
+
+#endif
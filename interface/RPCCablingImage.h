@@ -0,0 +1,105 @@
+#ifndef EventFilter_RPCRawToDigi_RPCCablingImage_H
+#define EventFilter_RPCRawToDigi_RPCCablingImage_H
+
+/** \class rpcrawtodigi::CablingImage
+ *  Flat, pointer free image of the RPC readout map used for unpacking.
+ *  For each LinkBoard the image holds the detUnitFrame of all its 96 packed
+ *  strips, sorted by the electronic index, so that lookups need neither
+ *  RPCReadOutMapping nor its specs. The image can be published in POSIX
+ *  shared memory by the first process converting a given map and attached
+ *  read-only by all the others.
+ *
+ *  The segment is named after a hash of the RPCEMap payload, not only of its
+ *  version string. It is built under a temporary name and published with an
+ *  atomic link, so an incomplete image is never visible. Each process using
+ *  a segment holds a shared flock on it; the last one to release the image
+ *  unlinks it, and create() removes segments left unlocked by crashed jobs.
+ *  Segments are private to the user (0600); attach() uses only segments
+ *  owned by the user with a consistent image, otherwise the caller creates
+ *  its own (possibly private) image.
+ */
+
+#include "CondFormats/RPCObjects/interface/RPCReadOutMapping.h"
+#include "CondFormats/RPCObjects/interface/LinkBoardElectronicIndex.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkBoardKey.h"
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace rpcrawtodigi {
+class CablingImage {
+public:
+
+  static const int nStripsInLB = 96;
+
+  struct Board { uint32_t key; uint32_t firstStrip; };
+  struct Strip { uint32_t rawDetId; int32_t strip; };
+
+  CablingImage();
+  ~CablingImage();
+
+  /// attach read-only to the shared image of the map with given hash (RPCEMapHash::map),
+  /// false if not available, not owned by the user or inconsistent
+  bool attach(uint64_t mapHash);
+
+  /// build image from cabling (converted from the map with given hash) and publish
+  /// it in shared memory. If publishing is not possible the image is kept in
+  /// private memory. Returns true if shared.
+  bool create(const RPCReadOutMapping & cabling, uint64_t mapHash);
+
+  /// build image in private memory only, nothing is published
+  void createPrivate(const RPCReadOutMapping & cabling);
+
+  /// release the image, the shared segment is unlinked if no other process uses it
+  void reset();
+
+  bool valid() const { return theHeader != 0; }
+  bool shared() const { return theMapped != 0; }
+  std::string version() const;
+  unsigned int nBoards() const;
+
+  /// fast search of the LinkBoard, 0 if not in map
+  const Board * board(const LinkBoardElectronicIndex & ele) const;
+
+  /// strip in detector unit for packed strip (0-95) of the LinkBoard
+  RPCReadOutMapping::StripInDetUnit detUnitFrame(const Board & board, int packedStrip) const {
+    if (packedStrip < 0 || packedStrip >= nStripsInLB) return RPCReadOutMapping::StripInDetUnit(0,0);
+    const Strip & s = theStrips[board.firstStrip+packedStrip];
+    return RPCReadOutMapping::StripInDetUnit(s.rawDetId, s.strip);
+  }
+
+  const Board * beginBoards() const { return theBoards; }
+  const Board * endBoards() const { return theBoards+nBoards(); }
+
+  static uint32_t key(const LinkBoardElectronicIndex & ele) { return linkBoardKey(ele); }
+  static LinkBoardElectronicIndex electronicIndex(uint32_t key) { return linkBoardIndex(key); }
+
+  /// name of the shared memory segment for given map hash
+  static std::string segmentName(uint64_t mapHash);
+
+private:
+  struct Header;
+  CablingImage(const CablingImage &);
+  CablingImage & operator=(const CablingImage &);
+  void setPointers(const char * image);
+  static std::vector<char> build(const RPCReadOutMapping & cabling, uint64_t mapHash);
+  /// complete image with consistent header, sorted boards and strip rows within image
+  static bool validImage(const char * image, uint64_t size);
+
+  /// unlink segments (also temporary ones) not locked by any process
+  static void removeUnusedSegments();
+
+private:
+  std::vector<char> thePrivate;
+  void * theMapped;
+  unsigned int theMappedSize;
+  int theFd;
+  std::string theSegment;
+
+  const Header * theHeader;
+  const Board * theBoards;
+  const Strip * theStrips;
+};
+}
+#endif
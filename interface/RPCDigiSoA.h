@@ -0,0 +1,42 @@
+#ifndef EventFilter_RPCRawToDigi_RPCDigiSoA_H
+#define EventFilter_RPCRawToDigi_RPCDigiSoA_H
+
+/** \class RPCDigiSoA
+ *  Compact structure-of-arrays copy of the unpacked RPC digis.
+ *  Hits are sorted by rawDetId, strip and bx; the hits of chamber i
+ *  (rawDetId chambers()[i]) are in [offsets()[i], offsets()[i+1]).
+ */
+
+#include <vector>
+#include <stdint.h>
+
+class RPCDigiSoA {
+public:
+
+  RPCDigiSoA() {}
+
+  /// hit packed in sortable 64 bit key, as filled by RPCRecordFormatter::recordUnpack
+  static uint64_t pack(uint32_t rawDetId, int strip, int bx) {
+    return (uint64_t(rawDetId) << 32) | (uint64_t(uint16_t(strip)) << 16) | uint16_t(bx+0x8000);
+  }
+
+  /// sort packed hits and fill arrays with them; packed hits are left sorted
+  void fill(std::vector<uint64_t> & packedHits);
+
+  unsigned int size() const { return theRawDetIds.size(); }
+  const std::vector<uint32_t> & rawDetIds() const { return theRawDetIds; }
+  const std::vector<uint16_t> & strips() const { return theStrips; }
+  const std::vector<int16_t> & bxs() const { return theBXs; }
+
+  unsigned int nChambers() const { return theChambers.size(); }
+  const std::vector<uint32_t> & chambers() const { return theChambers; }
+  const std::vector<uint32_t> & offsets() const { return theOffsets; }
+
+private:
+  std::vector<uint32_t> theRawDetIds;
+  std::vector<uint16_t> theStrips;
+  std::vector<int16_t> theBXs;
+  std::vector<uint32_t> theChambers;
+  std::vector<uint32_t> theOffsets;
+};
+#endif
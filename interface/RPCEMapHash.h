@@ -0,0 +1,39 @@
+#ifndef EventFilter_RPCRawToDigi_RPCEMapHash_H
+#define EventFilter_RPCRawToDigi_RPCEMapHash_H
+
+/** \class rpcrawtodigi::RPCEMapHash
+ *  FNV-1a hash of RPCEMap payload items. map() identifies the whole payload
+ *  (shared cabling image, unchanged IOVs); items can also be hashed one by
+ *  one, e.g. per link block for the incremental cabling index.
+ */
+
+#include "CondFormats/RPCObjects/interface/RPCEMap.h"
+#include <cstddef>
+#include <stdint.h>
+
+namespace rpcrawtodigi {
+class RPCEMapHash {
+public:
+  RPCEMapHash() : theValue(14695981039346656037ULL) {}
+
+  void add(const char * data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      theValue ^= static_cast<unsigned char>(data[i]);
+      theValue *= 1099511628211ULL;
+    }
+  }
+  void add(int value) { add(reinterpret_cast<const char*>(&value), sizeof(value)); }
+  void add(const RPCEMap::linkItem & link);
+  void add(const RPCEMap::lbItem & lb);
+  void add(const RPCEMap::febItem & feb);
+
+  uint64_t value() const { return theValue; }
+
+  /// hash of the whole payload (version and all items)
+  static uint64_t map(const RPCEMap & map);
+
+private:
+  uint64_t theValue;
+};
+}
+#endif
@@ -8,6 +8,8 @@
 #include "FWCore/Framework/interface/EDProducer.h"
 #include "EventFilter/RPCRawToDigi/interface/EventRecords.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "CondFormats/DataRecord/interface/RPCEMapRcd.h"
 #include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
 
 #include <vector> 
@@ -35,12 +37,25 @@ public:
   static std::vector<rpcrawtodigi::EventRecords> eventRecords(
       int fedId, int trigger_BX, const RPCDigiCollection* , const RPCRecordFormatter& ); 
 
+  /// data words with BX, SLD and CD records of one EventRecords each, last record empty
+  static std::vector<uint64_t> dataWords(const std::vector<rpcrawtodigi::EventRecords> & records);
+
+  /// FED payload of given data words with header and trailer, CRC filled
+  static FEDRawData * fedRawData( int fedId, unsigned int lvl1_ID, int trigger_BX,
+                                  const std::vector<uint64_t> & dataWords);
+
 private:
   FEDRawData * rawData( int fedId, unsigned int lvl1_ID, const RPCDigiCollection* , const RPCRecordFormatter& );
 
+  /// data words with 4 records each, BX and SLD records written only when changed
+  static std::vector<uint64_t> denseDataWords(std::vector<rpcrawtodigi::EventRecords> & records);
+
 private:
   edm::InputTag dataLabel_;
+  bool parallelFEDs_;
+  bool densePacking_;
   unsigned long eventCounter_;
+  edm::ESWatcher<RPCEMapRcd> recordWatcher_;
   const RPCReadOutMapping * theCabling; 
 
 };
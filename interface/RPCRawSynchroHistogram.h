@@ -0,0 +1,83 @@
+#ifndef EventFilter_RPCRawToDigi_RPCRawSynchroHistogram_H
+#define EventFilter_RPCRawToDigi_RPCRawSynchroHistogram_H
+
+/** \class RPCRawSynchroHistogram
+ *  Run summary of the data to trigger delays of the CD records,
+ *  (LinkBoard x delay) histogram, to be used instead of the per event
+ *  RPCRawSynchro::ProdItem (unpacker doSynchro off).
+ *  Only LinkBoards with data are stored, ordered by electronic index.
+ *
+ *  rpcrawtodigi::SynchroAccumulator is the dense counter used during the run.
+ */
+
+#include "CondFormats/RPCObjects/interface/LinkBoardElectronicIndex.h"
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+class RPCRawSynchroHistogram {
+public:
+
+  static const int nDelays = 8;
+
+  RPCRawSynchroHistogram() : theOutOfRange(0) {}
+
+  unsigned int size() const { return theLinks.size(); }
+
+  /// key of the LinkBoard (see rpcrawtodigi::linkBoardKey) and its nDelays counts
+  uint32_t link(unsigned int idx) const { return theLinks[idx]; }
+  const uint32_t * counts(unsigned int idx) const { return &theCounts[idx*nDelays]; }
+
+  /// counts of the LinkBoard, 0 if no data
+  const uint32_t * counts(const LinkBoardElectronicIndex & ele) const;
+
+  /// number of CD records with delay outside [0,nDelays) or with LinkBoard out of range
+  uint64_t outOfRange() const { return theOutOfRange; }
+
+  /// for filling, links must be pushed in increasing key order
+  void push_back(uint32_t link, const uint32_t * counts) {
+    theLinks.push_back(link);
+    theCounts.insert(theCounts.end(), counts, counts+nDelays);
+  }
+  void addOutOfRange(uint64_t n) { theOutOfRange += n; }
+
+  /// sum with the histogram of another part of the run, called by the framework
+  /// when run products are merged
+  bool mergeProduct(const RPCRawSynchroHistogram & o);
+
+  std::string print() const;
+
+private:
+  std::vector<uint32_t> theLinks;
+  std::vector<uint32_t> theCounts;
+  uint64_t theOutOfRange;
+};
+
+namespace rpcrawtodigi {
+class SynchroAccumulator {
+public:
+  SynchroAccumulator();
+
+  /// thread safe (atomic) increment of the (LinkBoard, delay) bin
+  void fill(const LinkBoardElectronicIndex & ele, int delay) {
+    int idx = index(ele);
+    if (idx < 0 || delay < 0 || delay >= RPCRawSynchroHistogram::nDelays) {
+      __atomic_fetch_add(&theOutOfRange, 1, __ATOMIC_RELAXED);
+    } else {
+      __atomic_fetch_add(&theCounts[idx*RPCRawSynchroHistogram::nDelays+delay], 1, __ATOMIC_RELAXED);
+    }
+  }
+
+  /// compact histogram of the filled LinkBoards
+  void fillHistogram(RPCRawSynchroHistogram & histo) const;
+
+  void clear();
+
+private:
+  static int index(const LinkBoardElectronicIndex & ele);
+
+  std::vector<uint32_t> theCounts;
+  uint64_t theOutOfRange;
+};
+}
+#endif
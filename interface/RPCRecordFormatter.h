@@ -10,14 +10,24 @@
 #include "DataFormats/RPCDigi/interface/RPCRawDataCounts.h"
 #include "DataFormats/RPCDigi/interface/RPCRawSynchro.h"
 #include "EventFilter/RPCRawToDigi/interface/EventRecords.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkHit.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCUnpackingInstrumentation.h"
 
 class RPCReadOutMapping;
+namespace rpcrawtodigi { class CablingImage; class SynchroAccumulator; class MaskedLocation; }
 #include <vector>
 
 class RPCRecordFormatter{
 public:
   ///Creator 
   RPCRecordFormatter(int fedId, const RPCReadOutMapping * readoutMapping);
+
+  ///Creator for unpacking with flat (possibly shared) cabling image
+  RPCRecordFormatter(int fedId, const rpcrawtodigi::CablingImage * cablingImage);
+
+  ///Creator for unpacking with LinkBoard search with strip masks,
+  ///masked strips are dropped before expansion of CD partition data
+  RPCRecordFormatter(int fedId, const rpcrawtodigi::MaskedLocation * maskedLocation);
 	   
   ///Destructor 
   ~RPCRecordFormatter();
@@ -30,11 +40,37 @@ public:
                     RPCRawDataCounts * counter, 
                     RPCRawSynchro::ProdItem * synchro);
 
+  /// as recordUnpack for a hit stored before mapping; EOD and mapping errors are counted for hit.dccId
+  int linkHitUnpack( const rpcrawtodigi::LinkHit & hit,
+                     RPCDigiCollection * prod,
+                     RPCRawDataCounts * counter,
+                     RPCRawSynchro::ProdItem * synchro);
+
+  /// optional counters of lookups and digis filled by recordUnpack
+  void setInstrumentation(RPCUnpackingInstrumentation::FedItem * item) { instrumentation = item; }
+
+  /// optional flat output of recordUnpack, hits packed as in RPCDigiSoA::pack
+  void setPackedDigis(std::vector<uint64_t> * hits) { packedDigis = hits; }
+
+  /// optional run level (LinkBoard x delay) histogram filled by recordUnpack
+  void setSynchroAccumulator(rpcrawtodigi::SynchroAccumulator * acc) { synchroAccumulator = acc; }
+
 private:    
+  int linkUnpack( const LinkBoardElectronicIndex & eleIndex,
+                  int partitionNumber, int partitionData, int delay,
+                  RPCDigiCollection * prod,
+                  RPCRawDataCounts * counter,
+                  RPCRawSynchro::ProdItem * synchro);
+
   int currentFED;
   int currentTbLinkInputNumber;
 
   const RPCReadOutMapping * readoutMapping;
+  const rpcrawtodigi::CablingImage * cablingImage;
+  RPCUnpackingInstrumentation::FedItem * instrumentation;
+  std::vector<uint64_t> * packedDigis;
+  rpcrawtodigi::SynchroAccumulator * synchroAccumulator;
+  const rpcrawtodigi::MaskedLocation * maskedLocation;
 };
 
 #endif
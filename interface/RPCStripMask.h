@@ -0,0 +1,47 @@
+#ifndef EventFilter_RPCRawToDigi_RPCStripMask_H
+#define EventFilter_RPCRawToDigi_RPCStripMask_H
+
+/** \class rpcrawtodigi::StripMask
+ *  Masked (or dead) strips of one LinkBoard: bit set for each of its 96
+ *  packed strips which is dropped in unpacking, one byte per CD partition.
+ *
+ *  rpcrawtodigi::MaskedLocation is a LinkBoard search giving the strips
+ *  and the mask of the board in the same lookup (see
+ *  RPCReadOutMappingWithFastSearch).
+ */
+
+#include "CondFormats/RPCObjects/interface/LinkBoardElectronicIndex.h"
+#include "CondFormats/RPCObjects/interface/RPCReadOutMapping.h"
+#include <stdint.h>
+
+namespace rpcrawtodigi {
+struct StripMask {
+  static const int nPartitions = 12;
+
+  StripMask() { for (int ip = 0; ip < nPartitions; ++ip) partition[ip] = 0; }
+
+  void set(int packedStrip) {
+    if (packedStrip >= 0 && packedStrip < 8*nPartitions) partition[packedStrip/8] |= 1 << (packedStrip%8);
+  }
+
+  /// masked bits of CD partition data
+  int masked(int partitionNumber, int partitionData) const {
+    return (partitionNumber >= 0 && partitionNumber < nPartitions) ? partitionData & partition[partitionNumber] : 0;
+  }
+
+  uint8_t partition[nPartitions];
+};
+
+class MaskedLocation {
+public:
+  static const int nStripsInLB = 96;
+
+  virtual ~MaskedLocation() {}
+
+  /// detUnitFrame of the nStripsInLB packed strips of the LinkBoard, 0 if not in map;
+  /// mask is 0 if no strip of the board is masked
+  virtual const RPCReadOutMapping::StripInDetUnit* strips(const LinkBoardElectronicIndex & ele,
+                                                          const StripMask* & mask) const = 0;
+};
+}
+#endif
@@ -0,0 +1,57 @@
+#ifndef EventFilter_RPCRawToDigi_RPCUnpackingInstrumentation_H
+#define EventFilter_RPCRawToDigi_RPCUnpackingInstrumentation_H
+
+/** \class RPCUnpackingInstrumentation
+ *  Per FED counters and timing of the RPC unpacker hot path.
+ *  Filled per event by RPCUnpackingModule when instrumentation is switched on,
+ *  and summed per run and per job for the summary. Times are in ns.
+ */
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+class RPCUnpackingInstrumentation {
+public:
+
+  static const unsigned int nRecordTypes = 10;
+
+  struct FedItem {
+    FedItem(int fed = 0);
+    void add(const FedItem & o);
+
+    int fedId;
+    uint64_t events;        // decoded FED payloads
+    uint64_t words;         // 64 bit words in payload
+    uint64_t records[nRecordTypes]; // per DataRecord::DataRecordType
+    uint64_t cdRecords;     // complete CD records given to mapping
+    uint64_t digis;
+    uint64_t lookups;       // LinkBoard searches
+    uint64_t lookupMisses;
+    uint64_t cacheHits;     // payloads taken from unpacking cache, not decoded
+    uint64_t maskedHits;    // fired strips dropped by strip masks
+    uint64_t crcMismatches; // payloads not decoded, trailer CRC differs from FedCrc
+    uint64_t wallHeaders, cpuHeaders;   // header and trailer checks
+    uint64_t wallRecords, cpuRecords;   // record walk, mapping included; for parallel
+                                        // chunks wall is elapsed, cpu summed over chunks
+    uint64_t wallMapping;   // part of wallRecords in lookup, strip mapping and digi insertion,
+                            // estimated from a sample of CD records
+  };
+
+  RPCUnpackingInstrumentation() {}
+
+  /// item of the FED, created if not there yet
+  FedItem & fed(int fedId);
+
+  const std::vector<FedItem> & feds() const { return theFeds; }
+
+  void add(const RPCUnpackingInstrumentation & o);
+
+  void clear() { theFeds.clear(); }
+
+  std::string print() const;
+
+private:
+  std::vector<FedItem> theFeds;
+};
+#endif
@@ -0,0 +1,144 @@
+#include "RPCDigiComparisonAnalyzer.h"
+#include "CondFormats/RPCObjects/interface/RPCReadOutMapping.h"
+#include "CondFormats/RPCObjects/interface/RPCEMap.h"
+#include "CondFormats/RPCObjects/interface/LinkBoardElectronicIndex.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <functional>
+
+using namespace edm;
+using namespace std;
+
+typedef DigiContainerIterator<RPCDetId, RPCDigi> DigiRangeIterator;
+
+
+RPCDigiComparisonAnalyzer::RPCDigiComparisonAnalyzer(const edm::ParameterSet& pset)
+  : firstLabel_(pset.getParameter<edm::InputTag>("firstLabel")),
+    secondLabel_(pset.getParameter<edm::InputTag>("secondLabel")),
+    maxChambersInSummary_(pset.getUntrackedParameter<unsigned int>("maxChambersInSummary",20)),
+    eventCounter_(0),
+    eventsWithMismatch_(0),
+    theCabling(0)
+{ }
+
+RPCDigiComparisonAnalyzer::~RPCDigiComparisonAnalyzer()
+{
+  delete theCabling;
+}
+
+void RPCDigiComparisonAnalyzer::stripsBX(const RPCDigiCollection::Range & range, StripsBX & result)
+{
+  result.clear();
+  for (vector<RPCDigi>::const_iterator id = range.first; id != range.second; ++id) {
+    result.push_back(make_pair(id->strip(), id->bx()));
+  }
+  sort(result.begin(), result.end());
+  result.erase(unique(result.begin(), result.end()), result.end());
+}
+
+RPCDigiComparisonAnalyzer::Stat RPCDigiComparisonAnalyzer::compare(const StripsBX & first, const StripsBX & second)
+{
+  Stat stat;
+  StripsBX::const_iterator i1 = first.begin(), i2 = second.begin();
+  while (i1 != first.end() && i2 != second.end()) {
+    if (*i1 < *i2) { stat.onlyFirst++; ++i1; }
+    else if (*i2 < *i1) { stat.onlySecond++; ++i2; }
+    else { stat.matched++; ++i1; ++i2; }
+  }
+  stat.onlyFirst += first.end()-i1;
+  stat.onlySecond += second.end()-i2;
+  return stat;
+}
+
+int RPCDigiComparisonAnalyzer::fed(uint32_t rawDetId, const StripsBX & digis)
+{
+  map<uint32_t,int>::const_iterator im = theChamberFeds.find(rawDetId);
+  if (im != theChamberFeds.end()) return im->second;
+  int fedId = -1;
+  if (theCabling && !digis.empty()) {
+    typedef vector< pair< LinkBoardElectronicIndex, LinkBoardPackedStrip> > RawDataFrames;
+    RawDataFrames frames = theCabling->rawDataFrame(RPCReadOutMapping::StripInDetUnit(rawDetId, digis.front().first));
+    if (!frames.empty()) fedId = frames.front().first.dccId;
+  }
+  theChamberFeds[rawDetId] = fedId;
+  return fedId;
+}
+
+void RPCDigiComparisonAnalyzer::analyze(const Event & ev, const EventSetup& es)
+{
+  eventCounter_++;
+  if (theRecordWatcher.check(es)) {
+    delete theCabling;
+    ESTransientHandle<RPCEMap> readoutMapping;
+    es.get<RPCEMapRcd>().get(readoutMapping);
+    theCabling = readoutMapping->convert();
+    theChamberFeds.clear();
+  }
+
+  Handle<RPCDigiCollection> first, second;
+  ev.getByLabel(firstLabel_, first);
+  ev.getByLabel(secondLabel_, second);
+
+  //
+  // both collections are ordered by detector unit, walk them together
+  //
+  bool mismatch = false;
+  DigiRangeIterator i1 = first->begin(), i2 = second->begin();
+  while (i1 != first->end() || i2 != second->end()) {
+    uint32_t det1 = (i1 != first->end()) ? (*i1).first.rawId() : 0xFFFFFFFF;
+    uint32_t det2 = (i2 != second->end()) ? (*i2).first.rawId() : 0xFFFFFFFF;
+    uint32_t rawDetId = min(det1, det2);
+    if (det1 == rawDetId) { stripsBX((*i1).second, theFirst); ++i1; } else theFirst.clear();
+    if (det2 == rawDetId) { stripsBX((*i2).second, theSecond); ++i2; } else theSecond.clear();
+
+    Stat stat = compare(theFirst, theSecond);
+    theChamberStats[rawDetId].add(stat);
+    theFedStats[fed(rawDetId, theFirst.empty() ? theSecond : theFirst)].add(stat);
+    if (stat.mismatched()) mismatch = true;
+  }
+  if (mismatch) eventsWithMismatch_++;
+}
+
+void RPCDigiComparisonAnalyzer::endJob()
+{
+  Stat total;
+  for (map<int,Stat>::const_iterator it = theFedStats.begin(); it != theFedStats.end(); ++it) total.add(it->second);
+
+  ostringstream str;
+  str << "events: " << eventCounter_ << " with mismatch: " << eventsWithMismatch_
+      << ", digis matched: " << total.matched << " only in " << firstLabel_.encode() << ": " << total.onlyFirst
+      << " only in " << secondLabel_.encode() << ": " << total.onlySecond << endl;
+
+  str << "  fed    matched  onlyFirst onlySecond" << endl;
+  for (map<int,Stat>::const_iterator it = theFedStats.begin(); it != theFedStats.end(); ++it) {
+    str << setw(5) << it->first << setw(11) << it->second.matched
+        << setw(11) << it->second.onlyFirst << setw(11) << it->second.onlySecond << endl;
+  }
+
+  //
+  // chambers with most mismatches
+  //
+  vector< pair<uint64_t,uint32_t> > worst;
+  for (map<uint32_t,Stat>::const_iterator it = theChamberStats.begin(); it != theChamberStats.end(); ++it) {
+    if (it->second.mismatched()) worst.push_back(make_pair(it->second.mismatched(), it->first));
+  }
+  unsigned int nShown = min<size_t>(worst.size(), maxChambersInSummary_);
+  partial_sort(worst.begin(), worst.begin()+nShown, worst.end(), greater< pair<uint64_t,uint32_t> >());
+  str << "chambers with mismatch: " << worst.size() << " of " << theChamberStats.size()
+      << ", first " << nShown << ":" << endl;
+  str << "     rawDetId    matched  onlyFirst onlySecond" << endl;
+  for (unsigned int iw = 0; iw < nShown; ++iw) {
+    const Stat & stat = theChamberStats[worst[iw].second];
+    str << setw(13) << worst[iw].second << setw(11) << stat.matched
+        << setw(11) << stat.onlyFirst << setw(11) << stat.onlySecond << endl;
+  }
+  LogInfo("RPCDigiComparisonAnalyzer") << str.str();
+}
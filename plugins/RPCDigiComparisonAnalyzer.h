@@ -0,0 +1,78 @@
+#ifndef RPCDigiComparisonAnalyzer_H
+#define RPCDigiComparisonAnalyzer_H
+
+
+/** \class RPCDigiComparisonAnalyzer
+ ** compares two RPCDigiCollections (e.g. simulated and after pack/unpack),
+ ** chamber by chamber with sorted merges. Counts of matched digis and of
+ ** digis found in one collection only are summed per chamber and per FED
+ ** and printed at the end of job.
+ **/
+
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "CondFormats/DataRecord/interface/RPCEMapRcd.h"
+#include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+
+class RPCReadOutMapping;
+namespace edm { class Event; class EventSetup; }
+
+class RPCDigiComparisonAnalyzer: public edm::EDAnalyzer {
+public:
+
+    ///Constructor
+    RPCDigiComparisonAnalyzer(const edm::ParameterSet& pset);
+
+    ///Destructor
+    virtual ~RPCDigiComparisonAnalyzer();
+
+    void analyze(const edm::Event & ev, const edm::EventSetup& es) override;
+
+    /// mismatch summary
+    void endJob() override;
+
+private:
+  struct Stat {
+    Stat() : matched(0), onlyFirst(0), onlySecond(0) {}
+    void add(const Stat & o) { matched += o.matched; onlyFirst += o.onlyFirst; onlySecond += o.onlySecond; }
+    uint64_t mismatched() const { return onlyFirst + onlySecond; }
+    uint64_t matched, onlyFirst, onlySecond;
+  };
+
+  typedef std::vector< std::pair<int,int> > StripsBX;
+
+  /// (strip, bx) of chamber digis, sorted and unique
+  static void stripsBX(const RPCDigiCollection::Range & range, StripsBX & result);
+
+  /// merge of sorted chamber digis
+  static Stat compare(const StripsBX & first, const StripsBX & second);
+
+  /// FED of the chamber, from the readout map; -1 if not known
+  int fed(uint32_t rawDetId, const StripsBX & digis);
+
+private:
+  edm::InputTag firstLabel_;
+  edm::InputTag secondLabel_;
+  unsigned int maxChambersInSummary_;
+  unsigned long eventCounter_;
+  unsigned long eventsWithMismatch_;
+
+  edm::ESWatcher<RPCEMapRcd> theRecordWatcher;
+  const RPCReadOutMapping* theCabling;
+  std::map<uint32_t,int> theChamberFeds;
+
+  std::map<uint32_t,Stat> theChamberStats;
+  std::map<int,Stat> theFedStats;
+
+  StripsBX theFirst, theSecond;
+};
+
+
+#endif
@@ -0,0 +1,62 @@
+#include "RPCLinkHitsToDigiModule.h"
+#include "CondFormats/RPCObjects/interface/RPCEMap.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCRecordFormatter.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkHit.h"
+#include "EventFilter/RPCRawToDigi/interface/DebugDigisPrintout.h"
+#include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
+#include "DataFormats/RPCDigi/interface/RPCRawDataCounts.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+using namespace edm;
+using namespace std;
+using namespace rpcrawtodigi;
+
+
+RPCLinkHitsToDigiModule::RPCLinkHitsToDigiModule(const edm::ParameterSet& pset)
+  : dataLabel_(pset.getParameter<edm::InputTag>("InputLabel"))
+{
+  produces<RPCDigiCollection>();
+  produces<RPCRawDataCounts>();
+}
+
+RPCLinkHitsToDigiModule::~RPCLinkHitsToDigiModule()
+{ }
+
+void RPCLinkHitsToDigiModule::beginRun(const edm::Run &run, const edm::EventSetup& es)
+{
+  if (theRecordWatcher.check(es)) {
+    LogTrace("") << "record has CHANGED!!, (re)initialise readout map!";
+    ESTransientHandle<RPCEMap> readoutMapping;
+    es.get<RPCEMapRcd>().get(readoutMapping);
+    unsigned int nConverted = theReadoutMappingSearch.init(*readoutMapping);
+    LogTrace("") <<" READOUT MAP VERSION: " << theReadoutMappingSearch.version()
+                 <<" (converted link blocks: " << nConverted << ")" << endl;
+  }
+}
+
+void RPCLinkHitsToDigiModule::produce(Event & ev, const EventSetup& es)
+{
+  static bool debug = edm::MessageDrop::instance()->debugEnabled;
+
+  Handle<RPCLinkHitCollection> linkHits;
+  ev.getByLabel(dataLabel_,linkHits);
+
+  std::auto_ptr<RPCDigiCollection> producedRPCDigis(new RPCDigiCollection);
+  std::auto_ptr<RPCRawDataCounts> producedRawDataCounts(new RPCRawDataCounts);
+
+  // hits are grouped by FED in unpacking order, fedId of the interpreter is used for packing only
+  RPCRecordFormatter interpreter(0, &theReadoutMappingSearch);
+  for (RPCLinkHitCollection::const_iterator it = linkHits->begin(); it != linkHits->end(); ++it) {
+    interpreter.linkHitUnpack(*it, producedRPCDigis.get(), producedRawDataCounts.get(), 0);
+  }
+
+  if (debug) LogTrace("") << DebugDigisPrintout()(producedRPCDigis.get()) << endl;
+  ev.put(producedRPCDigis);
+  ev.put(producedRawDataCounts);
+}
@@ -0,0 +1,45 @@
+#ifndef RPCLinkHitsToDigiModule_H
+#define RPCLinkHitsToDigiModule_H
+
+
+/** \class RPCLinkHitsToDigiModule
+ ** makes RPC digis from link hits stored by RPCUnpackingModule (doLinkHits),
+ ** with the cabling of the current RPCEMapRcd; raw data is not decoded again.
+ ** The RPCRawDataCounts product holds only the errors of the CD records
+ ** (EOD and mapping errors); record counts and FED header, trailer and
+ ** record sequence errors are in the counts of RPCUnpackingModule.
+ **/
+
+#include "FWCore/Framework/interface/one/EDProducer.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "CondFormats/DataRecord/interface/RPCEMapRcd.h"
+#include "RPCReadOutMappingWithFastSearch.h"
+
+
+namespace edm { class Event; class EventSetup; class Run; }
+
+class RPCLinkHitsToDigiModule: public edm::one::EDProducer<edm::one::WatchRuns> {
+public:
+
+    ///Constructor
+    RPCLinkHitsToDigiModule(const edm::ParameterSet& pset);
+
+    ///Destructor
+    virtual ~RPCLinkHitsToDigiModule();
+
+    void produce(edm::Event & ev, const edm::EventSetup& es) override;
+
+    void beginRun(const edm::Run &run, const edm::EventSetup& es) override;
+
+    void endRun(const edm::Run &run, const edm::EventSetup& es) override {}
+
+private:
+  edm::InputTag dataLabel_;
+
+  edm::ESWatcher<RPCEMapRcd> theRecordWatcher;
+  RPCReadOutMappingWithFastSearch theReadoutMappingSearch;
+};
+
+
+#endif
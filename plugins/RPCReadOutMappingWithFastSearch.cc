@@ -1,8 +1,15 @@
 #include "RPCReadOutMappingWithFastSearch.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCEMapHash.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkBoardKey.h"
+#include "CondFormats/RPCObjects/interface/RPCEMap.h"
+#include "CondFormats/RPCObjects/interface/LinkBoardPackedStrip.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include <vector>
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
+using namespace rpcrawtodigi;
 
 bool RPCReadOutMappingWithFastSearch::lessMap::operator()(
     const LinkBoardElectronicIndex & lb1, const LinkBoardElectronicIndex & lb2) const 
@@ -20,19 +27,88 @@ bool RPCReadOutMappingWithFastSearch::lessMap::operator()(
 }
 
 RPCReadOutMappingWithFastSearch::RPCReadOutMappingWithFastSearch()
-   : theMapping(0)
+   : theValid(false), theMasksChanged(false)
 {}
 
-void RPCReadOutMappingWithFastSearch::init(const RPCReadOutMapping * arm)
+void RPCReadOutMappingWithFastSearch::linkItems(const RPCEMap & map,
+    vector<LinkItems> & items, std::map<uint32_t,uint64_t> & hashes)
 {
-  if (theVersion==arm->version()) return;
+  //
+  // item ranges as walked by RPCEMap::convert, with hash of the items of each link
+  //
+  unsigned int iTB = 0, iLink = 0, iLB = 0, iFeb = 0;
+  for (unsigned int idcc = 0; idcc < map.theDccs.size(); ++idcc) {
+    for (int itb = 0; itb < map.theDccs[idcc].nTBs && iTB < map.theTBs.size(); ++itb, ++iTB) {
+      for (int il = 0; il < map.theTBs[iTB].nLinks && iLink < map.theLinks.size(); ++il, ++iLink) {
+        const RPCEMap::linkItem & link = map.theLinks[iLink];
+        LinkBoardElectronicIndex eleIndex;
+        eleIndex.dccId = map.theDccs[idcc].theId;
+        eleIndex.dccInputChannelNum = map.theTBs[iTB].theNum;
+        eleIndex.tbLinkInputNum = link.theTriggerBoardInputNumber;
+        eleIndex.lbNumInLink = 0;
+        LinkItems item = { linkBoardKey(eleIndex), idcc, iTB, iLink, iLB, 0, iFeb, 0 };
+        RPCEMapHash hash;
+        hash.add(link);
+        for (int ilb = 0; ilb < link.nLBs && iLB < map.theLBs.size(); ++ilb, ++iLB) {
+          hash.add(map.theLBs[iLB]);
+          for (int ifeb = 0; ifeb < map.theLBs[iLB].nFebs && iFeb < map.theFebs.size(); ++ifeb, ++iFeb) {
+            hash.add(map.theFebs[iFeb]);
+          }
+        }
+        item.nLBs = iLB - item.firstLB;
+        item.nFebs = iFeb - item.firstFeb;
+        items.push_back(item);
+        // a link given twice in the map is one block
+        uint64_t & h = hashes[item.key];
+        h = h ? (h*1099511628211ULL) ^ hash.value() : hash.value();
+      }
+    }
+  }
+}
 
-  theVersion=arm->version();
-  theLBMap.clear();
-  theMapping = arm;
+void RPCReadOutMappingWithFastSearch::convert(const RPCEMap & map, const vector<LinkItems> & items,
+    const set<uint32_t> & keys, LinkBlocks & blocks)
+{
+  //
+  // partial map with the selected links only, in the order of the full map,
+  // converted by RPCEMap::convert as the full map would be
+  //
+  RPCEMap part(map.theVersion);
+  int lastDcc = -1, lastTB = -1;
+  for (vector<LinkItems>::const_iterator it = items.begin(); it != items.end(); ++it) {
+    if (!keys.count(it->key)) continue;
+    if (int(it->dcc) != lastDcc) {
+      RPCEMap::dccItem dcc = map.theDccs[it->dcc];
+      dcc.nTBs = 0;
+      part.theDccs.push_back(dcc);
+      lastDcc = it->dcc;
+      lastTB = -1;
+    }
+    if (int(it->tb) != lastTB) {
+      RPCEMap::tbItem tb = map.theTBs[it->tb];
+      tb.nLinks = 0;
+      part.theTBs.push_back(tb);
+      part.theDccs.back().nTBs++;
+      lastTB = it->tb;
+    }
+    RPCEMap::linkItem link = map.theLinks[it->link];
+    link.nLBs = it->nLBs;
+    part.theLinks.push_back(link);
+    part.theTBs.back().nLinks++;
+    part.theLBs.insert(part.theLBs.end(), map.theLBs.begin()+it->firstLB, map.theLBs.begin()+it->firstLB+it->nLBs);
+    part.theFebs.insert(part.theFebs.end(), map.theFebs.begin()+it->firstFeb, map.theFebs.begin()+it->firstFeb+it->nFebs);
+  }
+  if (part.theLinks.empty()) return;
+
+  const RPCReadOutMapping * cabling = part.convert();
+  addBoards(*cabling, blocks);
+  delete cabling;
+}
 
+void RPCReadOutMappingWithFastSearch::addBoards(const RPCReadOutMapping & cabling, LinkBlocks & blocks)
+{
   typedef vector<const DccSpec*> DCCLIST;
-  DCCLIST dccList = arm->dccList();
+  DCCLIST dccList = cabling.dccList();
   for (DCCLIST::const_iterator idcc = dccList.begin(), idccEnd = dccList.end(); 
       idcc < idccEnd; ++idcc) {
     const DccSpec & dccSpec = **idcc;
@@ -45,22 +121,20 @@ void RPCReadOutMappingWithFastSearch::init(const RPCReadOutMapping * arm)
       for ( LINKS::const_iterator ic = linkConns.begin(); ic != linkConns.end(); ic++) {
 
         const LinkConnSpec & link = **ic;
+        LinkBoardElectronicIndex eleIndex;
+        eleIndex.dccId = dccSpec.id();
+        eleIndex.dccInputChannelNum = triggerBoard.dccInputChannelNum();
+        eleIndex.tbLinkInputNum = link.triggerBoardInputNumber();
+        eleIndex.lbNumInLink = 0;
+        LinkBlock & block = blocks[linkBoardKey(eleIndex)];
+
         const std::vector<LinkBoardSpec> & boards = link.linkBoards();
         for ( std::vector<LinkBoardSpec>::const_iterator
             ib = boards.begin(); ib != boards.end(); ib++) {
-
-          const LinkBoardSpec & board = (*ib);
-
-          LinkBoardElectronicIndex eleIndex;
-          eleIndex.dccId = dccSpec.id();
-          eleIndex.dccInputChannelNum = triggerBoard.dccInputChannelNum();
-          eleIndex.tbLinkInputNum = link.triggerBoardInputNumber();
-          eleIndex.lbNumInLink = board.linkBoardNumInLink();
-          LBMap::iterator inMap = theLBMap.find(eleIndex);  
-          if (inMap != theLBMap.end()) {
-            cout <<"The element in map already exists!"<< endl;
-          } else {
-            theLBMap[eleIndex] = &board;
+          eleIndex.lbNumInLink = ib->linkBoardNumInLink();
+          block.boards.push_back(linkBoardKey(eleIndex));
+          for (int is = 0; is < nStripsInLB; ++is) {
+            block.strips.push_back(cabling.detUnitFrame(*ib, LinkBoardPackedStrip(is)));
           }
         }
       }  
@@ -68,15 +142,127 @@ void RPCReadOutMappingWithFastSearch::init(const RPCReadOutMapping * arm)
   }
 }
 
-RPCReadOutMapping::StripInDetUnit RPCReadOutMappingWithFastSearch::detUnitFrame(
-    const LinkBoardSpec& location, const LinkBoardPackedStrip & lbstrip) const
+unsigned int RPCReadOutMappingWithFastSearch::init(const RPCEMap & map, bool incremental)
+{
+  vector<LinkItems> items;
+  std::map<uint32_t,uint64_t> hashes;
+  linkItems(map, items, hashes);
+
+  //
+  // blocks with the same items as in the index are kept. The conversion depends
+  // also on the map version (disk numbering), so with a new version one kept
+  // block is converted again as probe; if it differs, all blocks are converted.
+  //
+  set<uint32_t> keep;
+  if (incremental && theValid) {
+    for (std::map<uint32_t,uint64_t>::const_iterator ih = hashes.begin(); ih != hashes.end(); ++ih) {
+      LinkBlocks::const_iterator old = theBlocks.find(ih->first);
+      if (old != theBlocks.end() && old->second.hash == ih->second) keep.insert(ih->first);
+    }
+  }
+  if (!keep.empty() && map.theVersion != theVersion) {
+    set<uint32_t> probe;
+    for (set<uint32_t>::const_iterator ik = keep.begin(); ik != keep.end() && probe.empty(); ++ik) {
+      if (!theBlocks[*ik].boards.empty()) probe.insert(*ik);
+    }
+    LinkBlocks probed;
+    convert(map, items, probe, probed);
+    if (!probe.empty() && !probed[*probe.begin()].sameBoards(theBlocks[*probe.begin()])) keep.clear();
+  }
+
+  LinkBlocks blocks;
+  set<uint32_t> changed;
+  for (std::map<uint32_t,uint64_t>::const_iterator ih = hashes.begin(); ih != hashes.end(); ++ih) {
+    LinkBlock & block = blocks[ih->first];
+    block.hash = ih->second;
+    if (keep.count(ih->first)) {
+      LinkBlock & old = theBlocks[ih->first];
+      block.boards.swap(old.boards);
+      block.strips.swap(old.strips);
+    } else {
+      changed.insert(ih->first);
+    }
+  }
+  convert(map, items, changed, blocks);
+
+  theBlocks.swap(blocks);
+  theVersion = map.theVersion;
+  theValid = true;
+  initLBMap();
+  initMasks();
+
+  LogTrace("") << "RPCReadOutMappingWithFastSearch, version: " << theVersion
+               << " link blocks: " << theBlocks.size() << " converted: " << changed.size();
+  return changed.size();
+}
+
+bool RPCReadOutMappingWithFastSearch::check(const RPCReadOutMapping & cabling) const
+{
+  if (cabling.version() != theVersion) return false;
+  LinkBlocks full;
+  addBoards(cabling, full);
+  LinkBlocks::const_iterator it1 = theBlocks.begin(), it2 = full.begin();
+  while (true) {
+    while (it1 != theBlocks.end() && it1->second.boards.empty()) ++it1;
+    while (it2 != full.end() && it2->second.boards.empty()) ++it2;
+    if (it1 == theBlocks.end() || it2 == full.end()) return it1 == theBlocks.end() && it2 == full.end();
+    if (it1->first != it2->first || !it1->second.sameBoards(it2->second)) return false;
+    ++it1;
+    ++it2;
+  }
+}
+
+void RPCReadOutMappingWithFastSearch::initLBMap()
+{
+  theLBMap.clear();
+  for (LinkBlocks::const_iterator ib = theBlocks.begin(); ib != theBlocks.end(); ++ib) {
+    const LinkBlock & block = ib->second;
+    for (unsigned int idx = 0; idx < block.boards.size(); ++idx) {
+      LBEntry entry(&block.strips[idx*nStripsInLB]);
+      if (!theLBMap.insert(LBMap::value_type(linkBoardIndex(block.boards[idx]), entry)).second) {
+        cout <<"The element in map already exists!"<< endl;
+      }
+    }
+  }
+}
+
+void RPCReadOutMappingWithFastSearch::initMasks()
+{
+  //
+  // masks of LinkBoards with masked strips, attached to their entries. The
+  // strips of each LinkBoard are searched in the sorted masked strips.
+  //
+  theMasksChanged = false;
+  theMasks.clear();
+  for (LBMap::iterator entry = theLBMap.begin(); entry != theLBMap.end(); ++entry) {
+    entry->second.mask = 0;
+    if (theMaskedStrips.empty()) continue;
+    for (int packedStrip = 0; packedStrip < nStripsInLB; ++packedStrip) {
+      const StripInDetUnit & duFrame = entry->second.strips[packedStrip];
+      if (!duFrame.first) continue;
+      if (!binary_search(theMaskedStrips.begin(), theMaskedStrips.end(), duFrame)) continue;
+      StripMask & mask = theMasks[entry->first];
+      mask.set(packedStrip);
+      entry->second.mask = &mask;
+    }
+  }
+  LogTrace("") << "RPCReadOutMappingWithFastSearch, version: " << theVersion
+               << " LBs: " << theLBMap.size() << " masked: " << theMasks.size();
+}
+
+void RPCReadOutMappingWithFastSearch::setMaskedStrips(const vector<StripInDetUnit> & strips)
 {
-  return theMapping->detUnitFrame(location,lbstrip);
+  theMaskedStrips = strips;
+  sort(theMaskedStrips.begin(), theMaskedStrips.end());
+  theMaskedStrips.erase(unique(theMaskedStrips.begin(), theMaskedStrips.end()), theMaskedStrips.end());
+  theMasksChanged = true;
 }
 
-const LinkBoardSpec* RPCReadOutMappingWithFastSearch::location(const LinkBoardElectronicIndex & ele) const
+const RPCReadOutMapping::StripInDetUnit* RPCReadOutMappingWithFastSearch::strips(
+    const LinkBoardElectronicIndex & ele, const StripMask* & mask) const
 {
   LBMap::const_iterator inMap = theLBMap.find(ele);
-  return (inMap!= theLBMap.end()) ? inMap->second : 0;
-// return theMapping->location(ele);
+  if (inMap == theLBMap.end()) { mask = 0; return 0; }
+  mask = inMap->second.mask;
+  return inMap->second.strips;
 }
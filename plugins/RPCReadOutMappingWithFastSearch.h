@@ -1,32 +1,101 @@
 #ifndef RPCReadOutMappingWithFastSearch_H
 #define RPCReadOutMappingWithFastSearch_H
 
+/** \class RPCReadOutMappingWithFastSearch
+ *  LinkBoard search of the unpacker, with strip masks. For each LinkBoard the
+ *  detUnitFrame of its 96 packed strips is stored, no RPCReadOutMapping specs
+ *  are kept. The index is built from the RPCEMap payload in link blocks (one
+ *  TB link input with its LBs and FEBs); on a map change only the blocks with
+ *  changed items are converted, the others are kept.
+ */
+
 #include "CondFormats/RPCObjects/interface/RPCReadOutMapping.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCStripMask.h"
 #include <string>
+#include <vector>
 #include <map>
+#include <set>
+#include <stdint.h>
+
+class RPCEMap;
 
-class RPCReadOutMappingWithFastSearch : public RPCReadOutMapping {
+class RPCReadOutMappingWithFastSearch : public rpcrawtodigi::MaskedLocation {
 public:
+  typedef RPCReadOutMapping::StripInDetUnit StripInDetUnit;
+
   RPCReadOutMappingWithFastSearch();
-  virtual ~RPCReadOutMappingWithFastSearch(){} 
+  virtual ~RPCReadOutMappingWithFastSearch(){}
+
+  /// (re)build the index for the map. If incremental, only link blocks which are new
+  /// or changed are converted, otherwise the whole map is. Returns converted blocks.
+  unsigned int init(const RPCEMap & map, bool incremental = true);
 
-  /// takes ownership of map
-  void init(const RPCReadOutMapping * arm);
+  /// true if the index gives the strips of all LinkBoards of the (fully converted) cabling
+  bool check(const RPCReadOutMapping & cabling) const;
 
-  virtual const LinkBoardSpec* location (const LinkBoardElectronicIndex & ele) const;
+  /// strips dropped in unpacking; LinkBoard masks are rebuilt by the next init or updateMasks
+  void setMaskedStrips(const std::vector<StripInDetUnit> & strips);
 
-  virtual RPCReadOutMapping::StripInDetUnit detUnitFrame(
-      const LinkBoardSpec& location, const LinkBoardPackedStrip & lbstrip) const;
+  /// rebuild LinkBoard masks if masked strips changed since last build
+  void updateMasks() { if (theMasksChanged) initMasks(); }
+
+  bool valid() const { return theValid; }
+  const std::string & version() const { return theVersion; }
+  unsigned int nBoards() const { return theLBMap.size(); }
+
+  virtual const StripInDetUnit* strips(const LinkBoardElectronicIndex & ele,
+                                       const rpcrawtodigi::StripMask* & mask) const;
 
 private:
+  /// LinkBoards of one TB link input and their strips, nStripsInLB per board
+  struct LinkBlock {
+    LinkBlock() : hash(0) {}
+    bool sameBoards(const LinkBlock & o) const { return boards == o.boards && strips == o.strips; }
+    uint64_t hash;
+    std::vector<uint32_t> boards;
+    std::vector<StripInDetUnit> strips;
+  };
+  /// by rpcrawtodigi::linkBoardKey of the link (lbNumInLink 0)
+  typedef std::map<uint32_t, LinkBlock> LinkBlocks;
+
+  /// positions of the items of a link block in the RPCEMap vectors
+  struct LinkItems {
+    uint32_t key;
+    unsigned int dcc, tb, link, firstLB, nLBs, firstFeb, nFebs;
+  };
+
+  /// link blocks of the map and their item hashes
+  static void linkItems(const RPCEMap & map, std::vector<LinkItems> & items, std::map<uint32_t,uint64_t> & hashes);
+
+  /// convert the link blocks with given keys only (partial RPCEMap), boards added to blocks
+  static void convert(const RPCEMap & map, const std::vector<LinkItems> & items,
+                      const std::set<uint32_t> & keys, LinkBlocks & blocks);
+
+  /// boards of the cabling added to their link blocks
+  static void addBoards(const RPCReadOutMapping & cabling, LinkBlocks & blocks);
+
+  void initLBMap();
+  void initMasks();
+
+  bool theValid;
   std::string theVersion;
-  const RPCReadOutMapping * theMapping;
+  LinkBlocks theBlocks;
 
   struct lessMap {
      bool operator()(const LinkBoardElectronicIndex & lb1, const LinkBoardElectronicIndex & lb2) const;
   };
+  struct LBEntry {
+    LBEntry(const StripInDetUnit* s = 0) : strips(s), mask(0) {}
+    const StripInDetUnit* strips;
+    const rpcrawtodigi::StripMask* mask;
+  };
 
-  typedef std::map<LinkBoardElectronicIndex, const LinkBoardSpec*, lessMap> LBMap;
+  typedef std::map<LinkBoardElectronicIndex, LBEntry, lessMap> LBMap;
   LBMap theLBMap;
+
+  std::vector<StripInDetUnit> theMaskedStrips;  // sorted
+  bool theMasksChanged;
+  typedef std::map<LinkBoardElectronicIndex, rpcrawtodigi::StripMask, lessMap> MaskMap;
+  MaskMap theMasks;
 };
 #endif
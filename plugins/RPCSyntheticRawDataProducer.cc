@@ -0,0 +1,181 @@
+#include "RPCSyntheticRawDataProducer.h"
+#include "CondFormats/RPCObjects/interface/RPCReadOutMapping.h"
+#include "CondFormats/RPCObjects/interface/RPCEMap.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCPackingModule.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCRecordFormatter.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCCablingImage.h"
+#include "EventFilter/RPCRawToDigi/interface/EventRecords.h"
+#include "EventFilter/RPCRawToDigi/interface/FedCrc.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "DataFormats/FEDRawData/interface/FEDNumbering.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <set>
+#include <algorithm>
+#include <cmath>
+
+using namespace edm;
+using namespace std;
+using namespace rpcrawtodigi;
+
+typedef uint64_t Word64;
+
+namespace {
+  // readout window of the generated clusters relative to trigger BX, and BXs in orbit
+  const int minClusterBX = -3;
+  const int maxClusterBX = 4;
+  const int nBXs = 3564;
+}
+
+RPCSyntheticRawDataProducer::RPCSyntheticRawDataProducer(const edm::ParameterSet& pset)
+  : noiseRate_(pset.getParameter<double>("noiseRate")),
+    clusterSize_(pset.getParameter<double>("clusterSize")),
+    bxSpread_(pset.getParameter<double>("bxSpread")),
+    errorRecordRate_(pset.getParameter<double>("errorRecordRate")),
+    headerFaultRate_(pset.getParameter<double>("headerFaultRate")),
+    trailerFaultRate_(pset.getParameter<double>("trailerFaultRate")),
+    seed_(pset.getUntrackedParameter<unsigned int>("seed",12345)),
+    repeatEvent_(pset.getUntrackedParameter<bool>("repeatEvent",false)),
+    theEngine(seed_),
+    theCabling(0)
+{
+  produces<FEDRawDataCollection>();
+
+  for (unsigned int data = 0; data <= 0xFFFF; ++data) {
+    DataRecord record(data);
+    DataRecord::DataRecordType type = record.type();
+    if (type == DataRecord::RDDM || type == DataRecord::SDDM
+        || type == DataRecord::RCDM || type == DataRecord::RDM) theErrorRecords.push_back(data);
+  }
+}
+
+RPCSyntheticRawDataProducer::~RPCSyntheticRawDataProducer()
+{
+  delete theCabling;
+}
+
+void RPCSyntheticRawDataProducer::beginRun(const edm::Run &run, const edm::EventSetup& es)
+{
+  if (!theRecordWatcher.check(es)) return;
+  delete theCabling;
+  ESTransientHandle<RPCEMap> readoutMapping;
+  es.get<RPCEMapRcd>().get(readoutMapping);
+  theCabling = readoutMapping->convert();
+
+  //
+  // cabled channels, taken from a private flat image of the map (nothing published)
+  //
+  CablingImage image;
+  image.createPrivate(*theCabling);
+  set<Channel> channels;
+  for (const CablingImage::Board * ib = image.beginBoards(); ib != image.endBoards(); ++ib) {
+    for (int packedStrip = 0; packedStrip < CablingImage::nStripsInLB; ++packedStrip) {
+      RPCReadOutMapping::StripInDetUnit duFrame = image.detUnitFrame(*ib, packedStrip);
+      if (!duFrame.first || !duFrame.second) continue;
+      Channel channel = { duFrame.first, duFrame.second };
+      channels.insert(channel);
+    }
+  }
+  theChannels.assign(channels.begin(), channels.end());
+  LogInfo("RPCSyntheticRawDataProducer") << "READOUT MAP VERSION: " << theCabling->version()
+      << ", " << image.nBoards() << " LBs, " << theChannels.size() << " channels";
+}
+
+void RPCSyntheticRawDataProducer::fillDigis(RPCDigiCollection & digis)
+{
+  // distributions need positive mean and sigma: no clusters for zero noise (or no
+  // channels), extraStrips and bx are not drawn for single strip clusters and zero spread
+  double meanClusters = noiseRate_*theChannels.size();
+  if (meanClusters <= 0.) return;
+  poisson_distribution<int> nClusters(meanClusters);
+  poisson_distribution<int> extraStrips(clusterSize_ > 1. ? clusterSize_-1. : 1.);
+  uniform_int_distribution<unsigned int> seed(0, theChannels.size()-1);
+  normal_distribution<double> bx(0., bxSpread_ > 0. ? bxSpread_ : 1.);
+
+  //
+  // clusters of neighbouring strips of one detector unit, bx within readout window
+  //
+  set< pair<unsigned int,int> > hits;
+  for (int ic = nClusters(theEngine); ic > 0; --ic) {
+    unsigned int first = seed(theEngine);
+    int clusterBX = bxSpread_ > 0. ? int(floor(bx(theEngine)+0.5)) : 0;
+    clusterBX = min(max(clusterBX, minClusterBX), maxClusterBX);
+    int size = clusterSize_ > 1. ? 1 + extraStrips(theEngine) : 1;
+    for (unsigned int idx = first; idx < first+size && idx < theChannels.size(); ++idx) {
+      if (theChannels[idx].rawDetId != theChannels[first].rawDetId) break;
+      hits.insert(make_pair(idx, clusterBX));
+    }
+  }
+  for (set< pair<unsigned int,int> >::const_iterator it = hits.begin(); it != hits.end(); ++it) {
+    const Channel & channel = theChannels[it->first];
+    digis.insertDigi(RPCDetId(channel.rawDetId), RPCDigi(channel.strip, it->second));
+  }
+}
+
+FEDRawData * RPCSyntheticRawDataProducer::rawData(
+    int fedId, unsigned int lvl1_ID, int triggerBX, const RPCDigiCollection & digis)
+{
+  RPCRecordFormatter formatter(fedId, theCabling);
+  vector<EventRecords> merged = RPCPackingModule::eventRecords(fedId, triggerBX, &digis, formatter);
+
+  //
+  // data words as in RPCPackingModule, error record injected in place of the empty record
+  //
+  bernoulli_distribution injectError(errorRecordRate_);
+  uniform_int_distribution<unsigned int> errorRecord(0, theErrorRecords.size()-1);
+  vector<Word64> dataWords = RPCPackingModule::dataWords(merged);
+  for (vector<Word64>::iterator iw = dataWords.begin(); iw != dataWords.end(); ++iw) {
+    if (theErrorRecords.empty() || !injectError(theEngine)) continue;
+    *iw = (*iw & ~0xFFFFULL) | theErrorRecords[errorRecord(theEngine)];
+  }
+
+  FEDRawData * raw = RPCPackingModule::fedRawData(fedId, lvl1_ID, triggerBX, dataWords);
+  unsigned char * pHeader = raw->data();
+  unsigned char * pTrailer = pHeader + raw->size()-sizeof(Word64);
+
+  //
+  // faults: wrong BOE/EOE marker, so that header or trailer check fails. The CRC
+  // is computed again, so that a fault is not counted also as CRC mismatch
+  //
+  const Word64 markerBit = 1ULL << 60;
+  bool headerFault = bernoulli_distribution(headerFaultRate_)(theEngine);
+  bool trailerFault = bernoulli_distribution(trailerFaultRate_)(theEngine);
+  if (headerFault) *reinterpret_cast<Word64*>(pHeader) ^= markerBit;
+  if (trailerFault) *reinterpret_cast<Word64*>(pTrailer) ^= markerBit;
+  if (headerFault || trailerFault) {
+    Word64 * trailer = reinterpret_cast<Word64*>(pTrailer);
+    int nWords = raw->size()/sizeof(Word64);
+    Word64 crc = FedCrc::compute(reinterpret_cast<const Word64*>(pHeader), nWords);
+    *trailer = (*trailer & ~FedCrc::trailerCrcMask) | (crc << FedCrc::trailerCrcShift);
+  }
+
+  return raw;
+}
+
+void RPCSyntheticRawDataProducer::produce(Event & ev, const EventSetup& es)
+{
+  std::auto_ptr<FEDRawDataCollection> buffers(new FEDRawDataCollection);
+
+  // same hits, triggerBX and faults in every event, lvl1_ID fixed
+  if (repeatEvent_) theEngine.seed(seed_);
+
+  RPCDigiCollection digis;
+  fillDigis(digis);
+
+  unsigned int lvl1_ID = repeatEvent_ ? 1 : ev.id().event();
+  // trigger BX such that the BX of all clusters, triggerBX+clusterBX, stays in the orbit
+  int triggerBX = uniform_int_distribution<int>(1-minClusterBX, nBXs-1-maxClusterBX)(theEngine);
+  for (int fedId = FEDNumbering::MINRPCFEDID; fedId <= FEDNumbering::MAXRPCFEDID; ++fedId) {
+    FEDRawData * raw = rawData(fedId, lvl1_ID, triggerBX, digis);
+    buffers->FEDData(fedId) = *raw;
+    delete raw;
+  }
+  ev.put(buffers);
+}
@@ -0,0 +1,81 @@
+#ifndef RPCSyntheticRawDataProducer_H
+#define RPCSyntheticRawDataProducer_H
+
+
+/** \class RPCSyntheticRawDataProducer
+ ** FEDRawData of random RPC hits for unpacker scaling and stress tests.
+ ** Hits are generated on the channels of the RPCEMapRcd cabling (e.g. read
+ ** from sqlite file) at configurable noise rate, cluster size and BX spread,
+ ** packed with the RPCPackingModule eventRecords, dataWords and fedRawData;
+ ** error records and header or trailer faults can be injected. With
+ ** repeatEvent the same FEDRawData is produced in every event.
+ **/
+
+#include "FWCore/Framework/interface/one/EDProducer.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "CondFormats/DataRecord/interface/RPCEMapRcd.h"
+#include "DataFormats/RPCDigi/interface/DataRecord.h"
+#include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
+
+#include <vector>
+#include <random>
+#include <stdint.h>
+
+
+class RPCReadOutMapping;
+class FEDRawData;
+namespace edm { class Event; class EventSetup; class Run; }
+
+class RPCSyntheticRawDataProducer: public edm::one::EDProducer<edm::one::WatchRuns> {
+public:
+
+    ///Constructor
+    RPCSyntheticRawDataProducer(const edm::ParameterSet& pset);
+
+    ///Destructor
+    virtual ~RPCSyntheticRawDataProducer();
+
+    void produce(edm::Event & ev, const edm::EventSetup& es) override;
+
+    void beginRun(const edm::Run &run, const edm::EventSetup& es) override;
+
+    void endRun(const edm::Run &run, const edm::EventSetup& es) override {}
+
+private:
+  /// random hits on cabled channels
+  void fillDigis(RPCDigiCollection & digis);
+
+  /// packed FED payload with injected errors and faults
+  FEDRawData * rawData(int fedId, unsigned int lvl1_ID, int triggerBX, const RPCDigiCollection & digis);
+
+  /// channel with strip in detector unit
+  struct Channel {
+    uint32_t rawDetId;
+    int strip;
+    bool operator<(const Channel & o) const {
+      return rawDetId != o.rawDetId ? rawDetId < o.rawDetId : strip < o.strip;
+    }
+  };
+
+private:
+  double noiseRate_;
+  double clusterSize_;
+  double bxSpread_;
+  double errorRecordRate_;
+  double headerFaultRate_;
+  double trailerFaultRate_;
+  unsigned int seed_;
+  bool repeatEvent_;
+
+  std::mt19937 theEngine;
+
+  edm::ESWatcher<RPCEMapRcd> theRecordWatcher;
+  const RPCReadOutMapping* theCabling;
+  std::vector<Channel> theChannels;
+
+  /// all 16 bit values decoded as RDDM, SDDM, RCDM or RDM records
+  std::vector<rpcrawtodigi::DataRecord::Data> theErrorRecords;
+};
+
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef EventFilter_RPCRawToDigi_RPCUnpackingClock_H
+#define EventFilter_RPCRawToDigi_RPCUnpackingClock_H
+
+/** \class rpcrawtodigi::UnpackingClock
+ *  Clocks of the unpacker instrumentation, in ns.
+ *  wallTime is vdso backed and cheap; cpuTime (thread cpu time) is a
+ *  syscall and is read only at FED boundaries.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+namespace rpcrawtodigi {
+struct UnpackingClock {
+  static uint64_t wallTime() { return now(CLOCK_MONOTONIC); }
+  static uint64_t cpuTime() { return now(CLOCK_THREAD_CPUTIME_ID); }
+private:
+  static uint64_t now(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return uint64_t(ts.tv_sec)*1000000000ULL + ts.tv_nsec;
+  }
+};
+}
+#endif
@@ -10,6 +10,7 @@
 #include "DataFormats/RPCDigi/interface/RPCRawDataCounts.h"
 #include "DataFormats/Common/interface/Handle.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Run.h"
 //#include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/ESTransientHandle.h"
 #include "FWCore/Framework/interface/EventSetup.h"
@@ -20,14 +21,29 @@
 
 #include "CondFormats/RPCObjects/interface/RPCEMap.h"
 #include "CondFormats/DataRecord/interface/RPCEMapRcd.h"
+#include "CondFormats/RPCObjects/interface/RPCMaskedStrips.h"
+#include "CondFormats/RPCObjects/interface/RPCDeadStrips.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Utilities/interface/Exception.h"
 #include "DataFormats/RPCDigi/interface/DataRecord.h"
 #include "DataFormats/RPCDigi/interface/ReadoutError.h"
 #include "DataFormats/RPCDigi/interface/RPCRawSynchro.h"
 #include "EventFilter/RPCRawToDigi/interface/EventRecords.h"
 #include "EventFilter/RPCRawToDigi/interface/DebugDigisPrintout.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCUnpackingInstrumentation.h"
+#include "RPCUnpackingClock.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCDigiSoA.h"
+#include "EventFilter/RPCRawToDigi/interface/FedCrc.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCEMapHash.h"
+
+#include "tbb/parallel_for.h"
 
 #include <sstream>
+#include <fstream>
 #include <bitset>
+#include <algorithm>
+#include <cstring>
+#include <utility>
 
 using namespace edm;
 using namespace std;
@@ -39,32 +55,173 @@ typedef uint64_t Word64;
 RPCUnpackingModule::RPCUnpackingModule(const edm::ParameterSet& pset) 
   : dataLabel_(pset.getParameter<edm::InputTag>("InputLabel")),
     doSynchro_(pset.getParameter<bool>("doSynchro")),
+    doSynchroHistogram_(pset.getUntrackedParameter<bool>("doSynchroHistogram",false)),
+    useSharedCabling_(pset.getUntrackedParameter<bool>("useSharedCabling",false)),
+    doInstrumentation_(pset.getUntrackedParameter<bool>("doInstrumentation",false)),
+    doDigiSoA_(pset.getUntrackedParameter<bool>("doDigiSoA",false)),
+    checkCrc_(pset.getUntrackedParameter<bool>("checkCrc",false)),
+    doLinkHits_(pset.getUntrackedParameter<bool>("doLinkHits",false)),
+    useMaskedStripsRecords_(pset.getUntrackedParameter<bool>("useMaskedStripsRecords",false)),
+    theParallelChunkRecords(pset.getUntrackedParameter<unsigned int>("parallelChunkRecords",0)),
+    theUnpackCacheSize(pset.getUntrackedParameter<unsigned int>("unpackCacheSize",0)),
+    checkIncrementalCabling_(pset.getUntrackedParameter<bool>("checkIncrementalCabling",false)),
     eventCounter_(0),
-    theCabling(0)
+    theCablingHash(0),
+    theSynchroHighWater(0),
+    theLinkHitsHighWater(0),
+    theSynchroAccumulator(0),
+    theUnpackCache(0)
 {
   produces<RPCDigiCollection>();
   produces<RPCRawDataCounts>();
   if (doSynchro_) produces<RPCRawSynchro::ProdItem>();
+  if (doInstrumentation_) produces<RPCUnpackingInstrumentation>();
+  if (doDigiSoA_) produces<RPCDigiSoA>();
+  if (doLinkHits_) produces<RPCLinkHitCollection>();
+  if (doSynchroHistogram_) {
+    produces<RPCRawSynchroHistogram, edm::InRun>();
+    theSynchroAccumulator = new SynchroAccumulator;
+  }
+  if (theUnpackCacheSize) theUnpackCache = new UnpackCache(theUnpackCacheSize);
+
+  //
+  // local file of masked strips, one "rawDetId strip" pair per line, # for comments
+  //
+  std::string maskedStripsFile = pset.getUntrackedParameter<std::string>("maskedStripsFile","");
+  if (!maskedStripsFile.empty()) {
+    std::ifstream file(maskedStripsFile.c_str());
+    if (!file) throw cms::Exception("Configuration") << "cannot open maskedStripsFile " << maskedStripsFile;
+    std::string line;
+    while (std::getline(file, line)) {
+      std::istringstream str(line.substr(0, line.find('#')));
+      uint32_t rawDetId;
+      int strip;
+      if (str >> rawDetId >> strip) theFileMaskedStrips.push_back(RPCReadOutMapping::StripInDetUnit(rawDetId, strip));
+    }
+  }
 }
 
 RPCUnpackingModule::~RPCUnpackingModule()
 { 
-  delete theCabling;
+  delete theSynchroAccumulator;
+  delete theUnpackCache;
+}
+
+std::vector<RPCReadOutMapping::StripInDetUnit> RPCUnpackingModule::maskedStrips(const edm::EventSetup& es) const
+{
+  std::vector<RPCReadOutMapping::StripInDetUnit> strips(theFileMaskedStrips);
+  if (useMaskedStripsRecords_) {
+    ESHandle<RPCMaskedStrips> masked;
+    es.get<RPCMaskedStripsRcd>().get(masked);
+    for (std::vector<RPCMaskedStrips::MaskItem>::const_iterator it = masked->MaskVec.begin(); it != masked->MaskVec.end(); ++it) {
+      strips.push_back(RPCReadOutMapping::StripInDetUnit(it->rawId, it->strip));
+    }
+    ESHandle<RPCDeadStrips> dead;
+    es.get<RPCDeadStripsRcd>().get(dead);
+    for (std::vector<RPCDeadStrips::DeadItem>::const_iterator it = dead->DeadVec.begin(); it != dead->DeadVec.end(); ++it) {
+      strips.push_back(RPCReadOutMapping::StripInDetUnit(it->rawId, it->strip));
+    }
+  }
+  return strips;
 }
 
 void RPCUnpackingModule::beginRun(const edm::Run &run, const edm::EventSetup& es)
 {
-  if (theRecordWatcher.check(es)) {  
-    LogTrace("") << "record has CHANGED!!, (re)initialise readout map!";
-    delete theCabling; 
-    ESTransientHandle<RPCEMap> readoutMapping;
+  //
+  // strip masks are attached to the fast search index, not available with shared cabling image
+  //
+  bool masksChanged = false;
+  if (useMaskedStripsRecords_) {
+    masksChanged |= theMaskedStripsWatcher.check(es);
+    masksChanged |= theDeadStripsWatcher.check(es);
+  }
+  bool cablingChanged = theRecordWatcher.check(es);
+  if (!useSharedCabling_ && (cablingChanged || masksChanged)) {
+    theReadoutMappingSearch.setMaskedStrips(maskedStrips(es));
+  } else if (useSharedCabling_ && cablingChanged && (useMaskedStripsRecords_ || !theFileMaskedStrips.empty())) {
+    LogWarning("RPCUnpackingModule") << "strip masks are not applied with useSharedCabling";
+  }
+
+  ESTransientHandle<RPCEMap> readoutMapping;
+  uint64_t mapHash = 0;
+  if (cablingChanged) {
     es.get<RPCEMapRcd>().get(readoutMapping);
-    theCabling = readoutMapping->convert();
-    theReadoutMappingSearch.init(theCabling);
-     LogTrace("") <<" READOUT MAP VERSION: " << theCabling->version() << endl;
+    mapHash = RPCEMapHash::map(*readoutMapping);
+    if (mapHash == theCablingHash) {
+      // new IOV with identical payload: converted map and its index are kept
+      LogTrace("") << "record has CHANGED, same map payload, readout map kept";
+      cablingChanged = false;
+    }
+  }
+
+  if (masksChanged && !cablingChanged && theReadoutMappingSearch.valid()) {
+    theReadoutMappingSearch.updateMasks();
+    if (theUnpackCache) theUnpackCache->clear();
+  }
+
+  if (cablingChanged) {  
+    LogTrace("") << "record has CHANGED!!, (re)initialise readout map!";
+    theCablingHash = mapHash;
+    if (theUnpackCache) theUnpackCache->clear();
+    if (useSharedCabling_) {
+      //
+      // attach to image published by other process, convert only if not there yet
+      //
+      if (!theCablingImage.attach(mapHash)) {
+        const RPCReadOutMapping * cabling = readoutMapping->convert();
+        bool shared = theCablingImage.create(*cabling, mapHash);
+        delete cabling;
+        LogTrace("") <<" cabling image created, shared: " << shared;
+      }
+      LogTrace("") <<" READOUT MAP VERSION: " << theCablingImage.version()
+                   <<" (image with "<< theCablingImage.nBoards()<<" LBs)" << endl;
+    } else {
+      //
+      // only link blocks with changed items are converted, optionally checked
+      // against the conversion of the whole map
+      //
+      unsigned int nConverted = theReadoutMappingSearch.init(*readoutMapping);
+      if (checkIncrementalCabling_) {
+        std::auto_ptr<const RPCReadOutMapping> cabling(readoutMapping->convert());
+        if (!theReadoutMappingSearch.check(*cabling)) {
+          LogError("RPCUnpackingModule") << "incremental cabling index differs from full conversion"
+                                         << " of map " << cabling->version() << ", rebuilt";
+          nConverted = theReadoutMappingSearch.init(*readoutMapping, false);
+        }
+      }
+      LogTrace("") <<" READOUT MAP VERSION: " << theReadoutMappingSearch.version()
+                   <<" (converted link blocks: " << nConverted << ")" << endl;
+    }
   }
 }
 
+void RPCUnpackingModule::endRun(const edm::Run &run, const edm::EventSetup& es)
+{
+  if (!doInstrumentation_) return;
+  LogInfo("RPCUnpackingModule") << "instrumentation summary for run " << run.run() << endl
+                                << theRunInstrumentation.print();
+  theJobInstrumentation.add(theRunInstrumentation);
+  theRunInstrumentation.clear();
+}
+
+void RPCUnpackingModule::endRunProduce(edm::Run &run, const edm::EventSetup& es)
+{
+  if (!doSynchroHistogram_) return;
+  std::auto_ptr<RPCRawSynchroHistogram> producedSynchroHistogram(new RPCRawSynchroHistogram);
+  theSynchroAccumulator->fillHistogram(*producedSynchroHistogram);
+  theSynchroAccumulator->clear();
+  run.put(producedSynchroHistogram);
+}
+
+void RPCUnpackingModule::endJob()
+{
+  if (!doInstrumentation_) return;
+  theJobInstrumentation.add(theRunInstrumentation);
+  theRunInstrumentation.clear();
+  LogInfo("RPCUnpackingModule") << "instrumentation summary for job" << endl
+                                << theJobInstrumentation.print();
+}
+
 
 void RPCUnpackingModule::produce(Event & ev, const EventSetup& es)
 {
@@ -79,18 +236,44 @@ void RPCUnpackingModule::produce(Event & ev, const EventSetup& es)
   std::auto_ptr<RPCDigiCollection> producedRPCDigis(new RPCDigiCollection);
   std::auto_ptr<RPCRawDataCounts> producedRawDataCounts(new RPCRawDataCounts);
   std::auto_ptr<RPCRawSynchro::ProdItem> producedRawSynchoCounts;
-  if (doSynchro_) producedRawSynchoCounts.reset(new RPCRawSynchro::ProdItem);
+  if (doSynchro_) {
+    producedRawSynchoCounts.reset(new RPCRawSynchro::ProdItem);
+    producedRawSynchoCounts->reserve(theSynchroHighWater);
+  }
+  std::auto_ptr<RPCLinkHitCollection> producedLinkHits;
+  if (doLinkHits_) {
+    producedLinkHits.reset(new RPCLinkHitCollection);
+    producedLinkHits->reserve(theLinkHitsHighWater);
+  }
+  std::auto_ptr<RPCUnpackingInstrumentation> producedInstrumentation;
+  if (doInstrumentation_) producedInstrumentation.reset(new RPCUnpackingInstrumentation);
+  thePackedDigis.clear();
 
   int status = 0;
   for (int fedId= FEDNumbering::MINRPCFEDID; fedId<=FEDNumbering::MAXRPCFEDID; ++fedId){  
 
     const FEDRawData & rawData = allFEDRawData->FEDData(fedId);
     RPCRecordFormatter interpreter = 
-        theCabling ? RPCRecordFormatter(fedId,&theReadoutMappingSearch) : RPCRecordFormatter(fedId,0);
+        theCablingImage.valid() ? RPCRecordFormatter(fedId,&theCablingImage) :
+        theReadoutMappingSearch.valid() ? RPCRecordFormatter(fedId,&theReadoutMappingSearch) :
+        RPCRecordFormatter(fedId,static_cast<const RPCReadOutMapping*>(0));
     int triggerBX =0;
     int nWords = rawData.size()/sizeof(Word64);
     if (nWords==0) continue;
 
+    if (doSynchroHistogram_) interpreter.setSynchroAccumulator(theSynchroAccumulator);
+
+    RPCUnpackingInstrumentation::FedItem * timing = 0;
+    uint64_t wallStart = 0, cpuStart = 0;
+    if (doInstrumentation_) {
+      timing = &producedInstrumentation->fed(fedId);
+      timing->events++;
+      timing->words += nWords;
+      interpreter.setInstrumentation(timing);
+      wallStart = UnpackingClock::wallTime();
+      cpuStart = UnpackingClock::cpuTime();
+    }
+
     //
     // check headers
     //
@@ -153,6 +336,28 @@ void RPCUnpackingModule::produce(Event & ev, const EventSetup& es)
       }
     }
 
+    //
+    // check CRC, corrupted payload is not decoded. ReadoutError has no CRC type,
+    // a mismatch is counted as TrailerCheckFail (and as crcMismatches in instrumentation)
+    //
+    bool crcMismatch = false;
+    if (checkCrc_) {
+      const Word64* words = reinterpret_cast<const Word64* >(rawData.data());
+      FEDTrailer fedTrailer(reinterpret_cast<const unsigned char*>(words+nWords-1));
+      if (fedTrailer.check() && fedTrailer.crc() != FedCrc::compute(words, nWords)) {
+        producedRawDataCounts->addReadoutError(fedId, ReadoutError(ReadoutError::TrailerCheckFail));
+        if (timing) timing->crcMismatches++;
+        if (debug) LogTrace("") <<" ** PROBLEM **, CRC mismatch, skip data records";
+        crcMismatch = true;
+      }
+    }
+
+    if (timing) {
+      timing->wallHeaders += UnpackingClock::wallTime() - wallStart;
+      timing->cpuHeaders += UnpackingClock::cpuTime() - cpuStart;
+    }
+    if (crcMismatch) continue;
+
     //
     // data records
     //
@@ -165,40 +370,270 @@ void RPCUnpackingModule::produce(Event & ev, const EventSetup& es)
     }
 //    if (triggerBX != 51) continue;
 //    if (triggerBX != 2316) continue;
-    EventRecords event(triggerBX);
-    for (const Word64* word = header+1; word != trailer; word++) {
-      for( int iRecord=1; iRecord<=4; iRecord++){
-        const DataRecord::Data* pRecord = reinterpret_cast<const DataRecord::Data* >(word+1)-iRecord;
-        DataRecord record(*pRecord);
-        event.add(record);
-        if (debug) {
-          std::ostringstream str;
-          str <<"record: "<<record.print()<<" hex: "<<hex<<*pRecord<<dec;
-          str <<" type:"<<record.type()<<DataRecord::print(record);
-          if (event.complete()) {
-            str<< " --> dccId: "<<fedId
-               << " rmb: " <<event.recordSLD().rmb()
-               << " lnk: "<<event.recordSLD().tbLinkInputNumber()
-               << " lb: "<<event.recordCD().lbInLink()
-               << " part: "<<event.recordCD().partitionNumber()
-               << " data: "<<event.recordCD().partitionData()
-               << " eod: "<<event.recordCD().eod();
+    const Word64* data = header+1;
+    unsigned int nRecords = (trailer > data) ? 4*(trailer-data) : 0;
+    std::vector<uint64_t> * packedDigis = doDigiSoA_ ? &thePackedDigis : 0;
+
+    //
+    // payload seen before with the same cabling: products from cache, synchro histogram refilled
+    //
+    const Word64* words = reinterpret_cast<const Word64* >(rawData.data());
+    uint64_t payloadHash = 0;
+    if (theUnpackCache) {
+      payloadHash = UnpackCache::hash(words, nWords);
+      const Chunk * cached = theUnpackCache->find(fedId, payloadHash, words, nWords);
+      if (cached) {
+        mergeChunk(*cached, producedRPCDigis.get(), producedRawDataCounts.get(), producedRawSynchoCounts.get(),
+            producedLinkHits.get(), packedDigis);
+        if (doSynchroHistogram_) {
+          for (RPCRawSynchro::ProdItem::const_iterator it = cached->synchro.begin(); it != cached->synchro.end(); ++it) {
+            theSynchroAccumulator->fill(it->first, it->second);
           }
-          LogTrace("") << str.str();
         }
-        producedRawDataCounts->addDccRecord(fedId, record);
-        int statusTMP = 0;
-        if (event.complete() ) statusTMP= 
-            interpreter.recordUnpack( event, 
-            producedRPCDigis.get(), producedRawDataCounts.get(), producedRawSynchoCounts.get()); 
-        if (statusTMP != 0) status = statusTMP;
+        if (timing) timing->cacheHits++;
+        if (cached->status != 0) status = cached->status;
+        continue;
       }
     }
+
+    //
+    // decode, into cache entry if caching
+    //
+    RPCDigiCollection * digis = producedRPCDigis.get();
+    RPCRawDataCounts * counts = producedRawDataCounts.get();
+    RPCRawSynchro::ProdItem * synchro = producedRawSynchoCounts.get();
+    RPCLinkHitCollection * linkHits = producedLinkHits.get();
+    std::auto_ptr<Chunk> decoded;
+    if (theUnpackCache) {
+      decoded.reset(new Chunk);
+      digis = &decoded->digis;
+      counts = &decoded->counts;
+      synchro = (doSynchro_ || doSynchroHistogram_) ? &decoded->synchro : 0;
+      linkHits = doLinkHits_ ? &decoded->linkHits : 0;
+      packedDigis = doDigiSoA_ ? &decoded->packedDigis : 0;
+    }
+    interpreter.setPackedDigis(packedDigis);
+
+    int statusTMP = 0;
+    if (!debug && theParallelChunkRecords && nRecords >= 2*theParallelChunkRecords) {
+      statusTMP = unpackParallel(fedId, triggerBX, data, nRecords, interpreter,
+          digis, counts, synchro, linkHits, packedDigis, timing);
+    } else {
+      EventRecords & event = theEventRecords;
+      event.reset(triggerBX);
+      statusTMP = unpackRecords(fedId, data, 0, nRecords, event, interpreter,
+          digis, counts, synchro, linkHits, timing, debug);
+    }
+    if (decoded.get()) {
+      decoded->status = statusTMP;
+      mergeChunk(*decoded, producedRPCDigis.get(), producedRawDataCounts.get(), producedRawSynchoCounts.get(),
+          producedLinkHits.get(), doDigiSoA_ ? &thePackedDigis : 0);
+      theUnpackCache->insert(fedId, payloadHash, words, nWords, std::move(*decoded));
+    }
+    if (statusTMP != 0) status = statusTMP;
   }
   if (status && debug) LogTrace("")<<" RPCUnpackingModule - There was unpacking PROBLEM in this event"<<endl;
   if (debug) LogTrace("") << DebugDigisPrintout()(producedRPCDigis.get()) << endl;
   ev.put(producedRPCDigis);  
   ev.put(producedRawDataCounts);
-  if (doSynchro_) ev.put(producedRawSynchoCounts);
+  if (doSynchro_) {
+    theSynchroHighWater = std::max<size_t>(theSynchroHighWater, producedRawSynchoCounts->size());
+    ev.put(producedRawSynchoCounts);
+  }
+  if (doLinkHits_) {
+    theLinkHitsHighWater = std::max<size_t>(theLinkHitsHighWater, producedLinkHits->size());
+    ev.put(producedLinkHits);
+  }
+  if (doDigiSoA_) {
+    std::auto_ptr<RPCDigiSoA> producedDigiSoA(new RPCDigiSoA);
+    producedDigiSoA->fill(thePackedDigis);
+    ev.put(producedDigiSoA);
+  }
+  if (doInstrumentation_) {
+    theRunInstrumentation.add(*producedInstrumentation);
+    ev.put(producedInstrumentation);
+  }
+
+}
+
+int RPCUnpackingModule::unpackRecords(int fedId, const Word64* data,
+    unsigned int first, unsigned int last,
+    EventRecords & event, RPCRecordFormatter & interpreter,
+    RPCDigiCollection * digis, RPCRawDataCounts * counts, RPCRawSynchro::ProdItem * synchro,
+    RPCLinkHitCollection * linkHits, RPCUnpackingInstrumentation::FedItem * timing, bool debug)
+{
+  // thread cpu time only at the boundaries; mapping wall time sampled on every
+  // mappingSampling-th CD record and scaled, to keep clock reads off the record loop
+  static const unsigned int mappingSampling = 16;
+  uint64_t wallStart = 0, cpuStart = 0, wallMapping = 0;
+  unsigned int nCD = 0, nSampled = 0;
+  if (timing) {
+    wallStart = UnpackingClock::wallTime();
+    cpuStart = UnpackingClock::cpuTime();
+  }
+
+  int status = 0;
+  for (unsigned int idx = first; idx < last; ++idx) {
+    // records are taken from the most significant 16 bits of each word
+    const DataRecord::Data* pRecord = reinterpret_cast<const DataRecord::Data* >(data+idx/4+1)-1-idx%4;
+    DataRecord record(*pRecord);
+    event.add(record);
+    if (debug) {
+      std::ostringstream str;
+      str <<"record: "<<record.print()<<" hex: "<<hex<<*pRecord<<dec;
+      str <<" type:"<<record.type()<<DataRecord::print(record);
+      if (event.complete()) {
+        str<< " --> dccId: "<<fedId
+           << " rmb: " <<event.recordSLD().rmb()
+           << " lnk: "<<event.recordSLD().tbLinkInputNumber()
+           << " lb: "<<event.recordCD().lbInLink()
+           << " part: "<<event.recordCD().partitionNumber()
+           << " data: "<<event.recordCD().partitionData()
+           << " eod: "<<event.recordCD().eod();
+      }
+      LogTrace("") << str.str();
+    }
+    counts->addDccRecord(fedId, record);
+    if (timing) timing->records[std::min<unsigned int>(record.type(), RPCUnpackingInstrumentation::nRecordTypes-1)]++;
+    int statusTMP = 0;
+    if (event.complete() ) {
+      if (linkHits) linkHits->push_back(LinkHit(fedId, event));
+      bool sample = timing && nCD++ % mappingSampling == 0;
+      if (sample) wallMapping -= UnpackingClock::wallTime();
+      statusTMP= interpreter.recordUnpack( event, digis, counts, synchro); 
+      if (sample) {
+        wallMapping += UnpackingClock::wallTime();
+        nSampled++;
+      }
+    }
+    if (statusTMP != 0) status = statusTMP;
+  }
+
+  if (timing) {
+    timing->wallRecords += UnpackingClock::wallTime() - wallStart;
+    timing->cpuRecords += UnpackingClock::cpuTime() - cpuStart;
+    timing->cdRecords += nCD;
+    if (nSampled) timing->wallMapping += wallMapping*nCD/nSampled;
+  }
+  return status;
+}
 
+int RPCUnpackingModule::unpackParallel(int fedId, int triggerBX, const Word64* data, unsigned int nRecords,
+    const RPCRecordFormatter & interpreter,
+    RPCDigiCollection * digis, RPCRawDataCounts * counts, RPCRawSynchro::ProdItem * synchro,
+    RPCLinkHitCollection * linkHits, std::vector<uint64_t> * packedDigis,
+    RPCUnpackingInstrumentation::FedItem * timing)
+{
+  uint64_t wallStart = timing ? UnpackingClock::wallTime() : 0;
+
+  //
+  // pre-scan: split at StartOfBXData records, where EventRecords state is reset,
+  // in chunks of at least theParallelChunkRecords records
+  //
+  std::vector<unsigned int> bounds(1,0);
+  for (unsigned int idx = theParallelChunkRecords; idx < nRecords; ++idx) {
+    const DataRecord::Data* pRecord = reinterpret_cast<const DataRecord::Data* >(data+idx/4+1)-1-idx%4;
+    if (DataRecord(*pRecord).type() != DataRecord::StartOfBXData) continue;
+    bounds.push_back(idx);
+    idx += theParallelChunkRecords-1;
+  }
+  bounds.push_back(nRecords);
+
+  //
+  // decode chunks concurrently, each into its own products
+  //
+  std::vector<Chunk> chunks(bounds.size()-1);
+  tbb::parallel_for(size_t(0), chunks.size(), [&](size_t ic) {
+    Chunk & chunk = chunks[ic];
+    RPCRecordFormatter chunkInterpreter(interpreter);
+    chunkInterpreter.setPackedDigis(packedDigis ? &chunk.packedDigis : 0);
+    if (timing) chunkInterpreter.setInstrumentation(&chunk.timing);
+    EventRecords event(triggerBX);
+    chunk.status = unpackRecords(fedId, data, bounds[ic], bounds[ic+1], event, chunkInterpreter,
+        &chunk.digis, &chunk.counts, synchro ? &chunk.synchro : 0,
+        linkHits ? &chunk.linkHits : 0, timing ? &chunk.timing : 0, false);
+  });
+
+  //
+  // merge in order, giving the same products as serial decoding
+  //
+  int status = 0;
+  RPCUnpackingInstrumentation::FedItem chunkTiming(fedId);
+  for (std::vector<Chunk>::const_iterator ic = chunks.begin(); ic != chunks.end(); ++ic) {
+    mergeChunk(*ic, digis, counts, synchro, linkHits, packedDigis);
+    if (timing) chunkTiming.add(ic->timing);
+    if (ic->status != 0) status = ic->status;
+  }
+
+  //
+  // counters and cpu time summed over chunks, wall time is the elapsed time of
+  // split, decoding and merge; the mapping keeps its share of the chunk wall times
+  //
+  if (timing) {
+    uint64_t wallChunks = chunkTiming.wallRecords;
+    chunkTiming.wallRecords = UnpackingClock::wallTime() - wallStart;
+    chunkTiming.wallMapping = wallChunks ? chunkTiming.wallMapping*chunkTiming.wallRecords/wallChunks : 0;
+    timing->add(chunkTiming);
+  }
+  return status;
+}
+
+void RPCUnpackingModule::mergeChunk(const Chunk & chunk,
+    RPCDigiCollection * digis, RPCRawDataCounts * counts, RPCRawSynchro::ProdItem * synchro,
+    RPCLinkHitCollection * linkHits, std::vector<uint64_t> * packedDigis)
+{
+  typedef DigiContainerIterator<RPCDetId, RPCDigi> DigiRangeIterator;
+  for (DigiRangeIterator it = chunk.digis.begin(); it != chunk.digis.end(); ++it) {
+    digis->put((*it).second, (*it).first);
+  }
+  *counts += chunk.counts;
+  if (synchro) synchro->insert(synchro->end(), chunk.synchro.begin(), chunk.synchro.end());
+  if (linkHits) linkHits->insert(linkHits->end(), chunk.linkHits.begin(), chunk.linkHits.end());
+  if (packedDigis) packedDigis->insert(packedDigis->end(), chunk.packedDigis.begin(), chunk.packedDigis.end());
+}
+
+uint64_t RPCUnpackingModule::UnpackCache::hash(const Word64* data, unsigned int nWords)
+{
+  // multiply-rotate mix per 64 bit word, a few cycles against decoding of its 4 records
+  const uint64_t k = 0x9E3779B97F4A7C15ULL;
+  uint64_t h = k ^ nWords;
+  for (unsigned int iw = 0; iw < nWords; ++iw) {
+    uint64_t w = data[iw] * 0xFF51AFD7ED558CCDULL;
+    h ^= w ^ (w >> 32);
+    h = ((h << 27) | (h >> 37)) * k;
+  }
+  return h ^ (h >> 29);
+}
+
+const RPCUnpackingModule::Chunk * RPCUnpackingModule::UnpackCache::find(
+    int fedId, uint64_t hash, const Word64* data, unsigned int nWords)
+{
+  std::map<std::pair<int,uint64_t>, Entries::iterator>::const_iterator im = theIndex.find(make_pair(fedId,hash));
+  if (im == theIndex.end()) return 0;
+  Entries::iterator ie = im->second;
+  if (ie->payload.size() != nWords || memcmp(&ie->payload[0], data, nWords*sizeof(Word64)) != 0) return 0;
+  theEntries.splice(theEntries.begin(), theEntries, ie);
+  return &ie->decoded;
+}
+
+void RPCUnpackingModule::UnpackCache::insert(
+    int fedId, uint64_t hash, const Word64* data, unsigned int nWords, Chunk decoded)
+{
+  std::pair<int,uint64_t> key(fedId,hash);
+  std::map<std::pair<int,uint64_t>, Entries::iterator>::iterator im = theIndex.find(key);
+  if (im != theIndex.end()) {
+    // same hash, different payload: keep the latest
+    theEntries.erase(im->second);
+    theIndex.erase(im);
+  }
+  theEntries.push_front(Entry());
+  Entry & entry = theEntries.front();
+  entry.key = key;
+  entry.payload.assign(data, data+nWords);
+  entry.decoded = std::move(decoded);
+  theIndex[key] = theEntries.begin();
+  if (theEntries.size() > theMaxEntries) {
+    theIndex.erase(theEntries.back().key);
+    theEntries.pop_back();
+  }
 }
@@ -6,17 +6,32 @@
  ** unpacking RPC raw data
  **/
 
-#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/one/EDProducer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Framework/interface/ESWatcher.h"
 #include "CondFormats/DataRecord/interface/RPCEMapRcd.h"
+#include "CondFormats/DataRecord/interface/RPCMaskedStripsRcd.h"
+#include "CondFormats/DataRecord/interface/RPCDeadStripsRcd.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCCablingImage.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCUnpackingInstrumentation.h"
+#include "EventFilter/RPCRawToDigi/interface/EventRecords.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCRawSynchroHistogram.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCRecordFormatter.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkHit.h"
+#include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
+#include "DataFormats/RPCDigi/interface/RPCRawDataCounts.h"
+#include "DataFormats/RPCDigi/interface/RPCRawSynchro.h"
 #include "RPCReadOutMappingWithFastSearch.h"
 
+#include <vector>
+#include <list>
+#include <map>
+
 
 class RPCReadOutMapping;
 namespace edm { class Event; class EventSetup; class Run; }
 
-class RPCUnpackingModule: public edm::EDProducer {
+class RPCUnpackingModule: public edm::one::EDProducer<edm::one::WatchRuns, edm::EndRunProducer> {
 public:
     
     ///Constructor
@@ -31,15 +46,114 @@ public:
     void produce(edm::Event & ev, const edm::EventSetup& es) override; 
 
     void beginRun(const edm::Run &run, const edm::EventSetup& es) override;
+
+    /// instrumentation summary of the run
+    void endRun(const edm::Run &run, const edm::EventSetup& es) override;
+
+    /// puts run level synchro histogram
+    void endRunProduce(edm::Run &run, const edm::EventSetup& es) override;
+
+    /// instrumentation summary of the job
+    void endJob() override;
   
+private:
+
+  /// unpack data records [first,last) of FED payload
+  static int unpackRecords(int fedId, const uint64_t* data, unsigned int first, unsigned int last,
+      rpcrawtodigi::EventRecords & event, RPCRecordFormatter & interpreter,
+      RPCDigiCollection * digis, RPCRawDataCounts * counts, RPCRawSynchro::ProdItem * synchro,
+      RPCLinkHitCollection * linkHits, RPCUnpackingInstrumentation::FedItem * timing, bool debug);
+
+  /// unpack FED payload in chunks split at StartOfBXData records, decoded concurrently
+  int unpackParallel(int fedId, int triggerBX, const uint64_t* data, unsigned int nRecords,
+      const RPCRecordFormatter & interpreter,
+      RPCDigiCollection * digis, RPCRawDataCounts * counts, RPCRawSynchro::ProdItem * synchro,
+      RPCLinkHitCollection * linkHits, std::vector<uint64_t> * packedDigis,
+      RPCUnpackingInstrumentation::FedItem * timing);
+
+  /// products of one chunk of FED payload
+  struct Chunk {
+    Chunk() : status(0) {}
+    RPCDigiCollection digis;
+    RPCRawDataCounts counts;
+    RPCRawSynchro::ProdItem synchro;
+    RPCLinkHitCollection linkHits;
+    std::vector<uint64_t> packedDigis;
+    RPCUnpackingInstrumentation::FedItem timing;
+    int status;
+  };
+
+  /// strips dropped in unpacking: from file and, if requested, from masked and dead strips records
+  std::vector<RPCReadOutMapping::StripInDetUnit> maskedStrips(const edm::EventSetup& es) const;
+
+  /// append chunk products (timing excluded) to event products, null products are skipped
+  static void mergeChunk(const Chunk & chunk,
+      RPCDigiCollection * digis, RPCRawDataCounts * counts, RPCRawSynchro::ProdItem * synchro,
+      RPCLinkHitCollection * linkHits, std::vector<uint64_t> * packedDigis);
+
+  /// bounded LRU cache of decoded FED payloads, for replay of the same raw events.
+  /// Keyed on (fedId, payload hash), payload compared on hit; cleared on cabling change.
+  class UnpackCache {
+  public:
+    explicit UnpackCache(unsigned int maxEntries) : theMaxEntries(maxEntries) {}
+
+    static uint64_t hash(const uint64_t* data, unsigned int nWords);
+
+    /// decoded payload, 0 if not in cache
+    const Chunk * find(int fedId, uint64_t hash, const uint64_t* data, unsigned int nWords);
+
+    void insert(int fedId, uint64_t hash, const uint64_t* data, unsigned int nWords, Chunk decoded);
+
+    void clear() { theEntries.clear(); theIndex.clear(); }
+
+  private:
+    struct Entry {
+      std::pair<int,uint64_t> key;
+      std::vector<uint64_t> payload;
+      Chunk decoded;
+    };
+    typedef std::list<Entry> Entries;   // most recently used first
+    unsigned int theMaxEntries;
+    Entries theEntries;
+    std::map<std::pair<int,uint64_t>, Entries::iterator> theIndex;
+  };
+
 private:
   edm::InputTag dataLabel_;
   bool doSynchro_; 
+  bool doSynchroHistogram_;
+  bool useSharedCabling_;
+  bool doInstrumentation_;
+  bool doDigiSoA_;
+  bool checkCrc_;
+  bool doLinkHits_;
+  bool useMaskedStripsRecords_;
+  unsigned int theParallelChunkRecords;
+  unsigned int theUnpackCacheSize;
+  bool checkIncrementalCabling_;
   unsigned long eventCounter_;
 
   edm::ESWatcher<RPCEMapRcd> theRecordWatcher;
-  const RPCReadOutMapping* theCabling;
+  uint64_t theCablingHash;
   RPCReadOutMappingWithFastSearch theReadoutMappingSearch;
+  edm::ESWatcher<RPCMaskedStripsRcd> theMaskedStripsWatcher;
+  edm::ESWatcher<RPCDeadStripsRcd> theDeadStripsWatcher;
+  std::vector<RPCReadOutMapping::StripInDetUnit> theFileMaskedStrips;
+  rpcrawtodigi::CablingImage theCablingImage;
+
+  RPCUnpackingInstrumentation theRunInstrumentation;
+  RPCUnpackingInstrumentation theJobInstrumentation;
+
+  //
+  // scratch buffers and product sizes kept between events, to avoid regrowing them
+  //
+  rpcrawtodigi::EventRecords theEventRecords;
+  std::vector<uint64_t> thePackedDigis;
+  size_t theSynchroHighWater;
+  size_t theLinkHitsHighWater;
+
+  rpcrawtodigi::SynchroAccumulator * theSynchroAccumulator;
+  UnpackCache * theUnpackCache;
 };
 
 
@@ -2,8 +2,14 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "RPCUnpackingModule.h"
+#include "RPCLinkHitsToDigiModule.h"
+#include "RPCSyntheticRawDataProducer.h"
+#include "RPCDigiComparisonAnalyzer.h"
 #include "EventFilter/RPCRawToDigi/interface/RPCPackingModule.h"
 
 
 DEFINE_FWK_MODULE(RPCUnpackingModule);
 DEFINE_FWK_MODULE(RPCPackingModule);
+DEFINE_FWK_MODULE(RPCLinkHitsToDigiModule);
+DEFINE_FWK_MODULE(RPCSyntheticRawDataProducer);
+DEFINE_FWK_MODULE(RPCDigiComparisonAnalyzer);
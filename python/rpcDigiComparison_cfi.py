@@ -0,0 +1,9 @@
+import FWCore.ParameterSet.Config as cms
+
+# per chamber and per FED comparison of two digi collections, summary at end of job
+rpcDigiComparison = cms.EDAnalyzer("RPCDigiComparisonAnalyzer",
+    firstLabel = cms.InputTag("simMuonRPCDigis"),
+    secondLabel = cms.InputTag("rpcunpacker"),
+    # chambers with most mismatches listed in the summary
+    maxChambersInSummary = cms.untracked.uint32(20)
+)
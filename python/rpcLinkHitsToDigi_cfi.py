@@ -0,0 +1,7 @@
+import FWCore.ParameterSet.Config as cms
+
+# digis from link hits of rpcunpacker (doLinkHits = True), re-mapped with current RPCEMapRcd;
+# its RPCRawDataCounts holds only EOD and mapping errors, not record counts or FED errors
+rpcLinkHitsToDigi = cms.EDProducer("RPCLinkHitsToDigiModule",
+    InputLabel = cms.InputTag("rpcunpacker")
+)
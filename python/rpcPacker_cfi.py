@@ -1,7 +1,11 @@
 import FWCore.ParameterSet.Config as cms
 
 rpcpacker = cms.EDProducer("RPCPackingModule",
-  InputLabel = cms.InputTag("simMuonRPCDigis")
+  InputLabel = cms.InputTag("simMuonRPCDigis"),
+  # pack FEDs concurrently, output identical to serial packing
+  parallelFEDs = cms.untracked.bool(True),
+  # write BX and SLD records only when changed, 4 records per word
+  densePacking = cms.untracked.bool(False)
 )
 
 
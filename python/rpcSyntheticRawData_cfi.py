@@ -0,0 +1,19 @@
+import FWCore.ParameterSet.Config as cms
+
+# random RPC raw data on the channels of RPCEMapRcd cabling, for unpacker stress tests
+rpcSyntheticRawData = cms.EDProducer("RPCSyntheticRawDataProducer",
+    # probability per cabled strip and event to start a cluster
+    noiseRate = cms.double(0.001),
+    # mean number of neighbouring strips in a cluster
+    clusterSize = cms.double(1.5),
+    # gaussian sigma of cluster BX around trigger BX, clipped to readout window [-3,4]
+    bxSpread = cms.double(0.5),
+    # probability per CD record of a following RDDM/SDDM/RCDM/RDM error record
+    errorRecordRate = cms.double(0.),
+    # probability per FED of a broken header or trailer
+    headerFaultRate = cms.double(0.),
+    trailerFaultRate = cms.double(0.),
+    seed = cms.untracked.uint32(12345),
+    # same raw data in every event (engine reseeded, lvl1_ID 1), e.g. for unpack cache tests
+    repeatEvent = cms.untracked.bool(False)
+)
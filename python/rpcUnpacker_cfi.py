@@ -2,7 +2,34 @@ import FWCore.ParameterSet.Config as cms
 
 rpcunpacker = cms.EDProducer("RPCUnpackingModule",
     InputLabel = cms.InputTag("rawDataCollector"),
-    doSynchro = cms.bool(True)
+    doSynchro = cms.bool(True),
+    # run level (LinkBoard x delay) histogram; independent of doSynchro, set
+    # doSynchro = False to drop the per event synchro product
+    doSynchroHistogram = cms.untracked.bool(False),
+    # attach to cabling image in POSIX shared memory, created by first process
+    useSharedCabling = cms.untracked.bool(False),
+    # without shared cabling only changed link blocks of a new map are converted;
+    # check the index against a conversion of the whole map (slow, validation only)
+    checkIncrementalCabling = cms.untracked.bool(False),
+    # per FED counters and timing of unpacking, with run and job summary
+    doInstrumentation = cms.untracked.bool(False),
+    # flat structure-of-arrays copy of the digis (RPCDigiSoA)
+    doDigiSoA = cms.untracked.bool(False),
+    # verify FED trailer CRC, payloads with wrong CRC are not decoded
+    checkCrc = cms.untracked.bool(False),
+    # cabling independent hits of complete CD records, for re-mapping
+    # with RPCLinkHitsToDigiModule
+    doLinkHits = cms.untracked.bool(False),
+    # decode FED payloads larger than 2x this number of records concurrently,
+    # in chunks split at StartOfBXData records; 0 - always serial
+    parallelChunkRecords = cms.untracked.uint32(0),
+    # number of decoded FED payloads kept (LRU) for replays of the same raw
+    # events with the same cabling; 0 - no cache
+    unpackCacheSize = cms.untracked.uint32(0),
+    # strips dropped in unpacking (not with useSharedCabling): local file with
+    # "rawDetId strip" lines and/or RPCMaskedStripsRcd and RPCDeadStripsRcd
+    maskedStripsFile = cms.untracked.string(''),
+    useMaskedStripsRecords = cms.untracked.bool(False)
 )
 
 
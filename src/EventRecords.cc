@@ -23,26 +23,30 @@ void EventRecords::add(const DataRecord & record)
 {
   
   if (record.type() == DataRecord::StartOfBXData) {
-    theRecordBX = RecordBX(record);
+    theRecordBX = record.data();
     theValidBX = true;
     theValidLN = false;
     theValidCD = false;
-    theErrors.clear();
+    theNErrors = 0;
+    theErrorOverflow = 0;
   }
   else if (record.type() == DataRecord::StartOfTbLinkInputNumberData) {
-    theRecordSLD = RecordSLD(record);
+    theRecordSLD = record.data();
     theValidLN = true;
     theValidCD = false;
   }
   else if (record.type() == DataRecord::ChamberData) {
-    theRecordCD = RecordCD(record);
+    theRecordCD = record.data();
     theValidCD = true;
   } 
   else {
 //    theValidBX = false;
 //    theValidLN = false;
     theValidCD = false;
-    if ( record.type() > DataRecord::Empty) theErrors.push_back(record);
+    if ( record.type() > DataRecord::Empty) {
+      if (theNErrors < nInlineErrors) theErrors[theNErrors++] = record.data();
+      else theErrorOverflow++;
+    }
   }
 }
 
@@ -61,6 +65,7 @@ bool EventRecords::samePartition(const EventRecords & r) const
 vector<EventRecords> EventRecords::mergeRecords(const vector<EventRecords> & data)
 {
   std::vector<EventRecords> result;
+  result.reserve(data.size());
   typedef vector<EventRecords>::const_iterator ICR;
   typedef vector<EventRecords>::iterator IR;
   for (ICR id= data.begin(), idEnd = data.end(); id != idEnd; ++id) {
@@ -84,15 +89,17 @@ std::string EventRecords::print(const DataRecord::DataRecordType& type) const
 {
   std::ostringstream str;
   str <<" ==>";
-  if (type == DataRecord::StartOfBXData && theValidBX)               str << theRecordBX.print(); 
-  if (type == DataRecord::StartOfTbLinkInputNumberData&& theValidLN) str << theRecordSLD.print(); 
-  if (type == DataRecord::ChamberData && theValidCD)               str << theRecordCD.print();
+  if (type == DataRecord::StartOfBXData && theValidBX)               str << recordBX().print(); 
+  if (type == DataRecord::StartOfTbLinkInputNumberData&& theValidLN) str << recordSLD().print(); 
+  if (type == DataRecord::ChamberData && theValidCD)               str << recordCD().print();
   if (type == DataRecord::Empty)                                   str <<" EPMTY";
-  for (vector<DataRecord>::const_iterator ie=theErrors.begin(); ie < theErrors.end(); ++ie) { 
-    if (type == DataRecord::RDDM)   str << ErrorRDDM(*ie).print(); 
-    if (type == DataRecord::SDDM)   str << ErrorSDDM(*ie).print(); 
-    if (type == DataRecord::RCDM)   str << ErrorRCDM(*ie).print(); 
-    if (type == DataRecord::RDM)   str << ErrorRDM(*ie).print(); 
+  for (int ie = 0; ie < theNErrors; ++ie) { 
+    DataRecord error(theErrors[ie]);
+    if (type == DataRecord::RDDM)   str << ErrorRDDM(error).print(); 
+    if (type == DataRecord::SDDM)   str << ErrorSDDM(error).print(); 
+    if (type == DataRecord::RCDM)   str << ErrorRCDM(error).print(); 
+    if (type == DataRecord::RDM)   str << ErrorRDM(error).print(); 
   }
+  if (theErrorOverflow) str << " (+" << theErrorOverflow << " errors not stored)";
   return str.str();
 }
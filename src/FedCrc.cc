@@ -0,0 +1,40 @@
+#include "EventFilter/RPCRawToDigi/interface/FedCrc.h"
+
+using namespace rpcrawtodigi;
+
+namespace {
+  struct CrcTables {
+    uint16_t t[8][256];
+    CrcTables() {
+      for (unsigned int b = 0; b < 256; ++b) {
+        uint16_t crc = b << 8;
+        for (int i = 0; i < 8; ++i) crc = (crc & 0x8000) ? (crc << 1) ^ 0x8005 : (crc << 1);
+        t[0][b] = crc;
+      }
+      // t[k][b]: register after byte b followed by k zero bytes
+      for (int k = 1; k < 8; ++k) {
+        for (unsigned int b = 0; b < 256; ++b) {
+          uint16_t prev = t[k-1][b];
+          t[k][b] = (prev << 8) ^ t[0][prev >> 8];
+        }
+      }
+    }
+  };
+  const CrcTables theTables;
+}
+
+uint16_t FedCrc::compute(const uint64_t * data, unsigned int nWords)
+{
+  const uint16_t (*t)[256] = theTables.t;
+  uint16_t crc = 0xFFFF;
+  for (unsigned int iw = 0; iw < nWords; ++iw) {
+    uint64_t w = data[iw];
+    if (iw == nWords-1) w &= ~trailerCrcMask;
+    w ^= uint64_t(crc) << 48;
+    crc = t[7][w >> 56]         ^ t[6][(w >> 48) & 0xFF]
+        ^ t[5][(w >> 40) & 0xFF] ^ t[4][(w >> 32) & 0xFF]
+        ^ t[3][(w >> 24) & 0xFF] ^ t[2][(w >> 16) & 0xFF]
+        ^ t[1][(w >>  8) & 0xFF] ^ t[0][w & 0xFF];
+  }
+  return crc;
+}
@@ -0,0 +1,305 @@
+#include "EventFilter/RPCRawToDigi/interface/RPCCablingImage.h"
+
+#include "CondFormats/RPCObjects/interface/LinkBoardPackedStrip.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+using namespace rpcrawtodigi;
+using namespace std;
+
+struct CablingImage::Header {
+  char     magic[8];
+  uint32_t complete;
+  uint32_t size;
+  uint32_t nBoards;
+  uint32_t nStrips;
+  uint64_t mapHash;
+  char     version[256];
+};
+
+namespace {
+  const char theMagic[8] = { 'R','P','C','C','A','B','L','2' };
+  const char theSegmentPrefix[] = "RPCCablingImage_";
+  const string theShmDir = "/dev/shm/";
+
+  bool lessKey(const CablingImage::Board & b, uint32_t key) { return b.key < key; }
+
+  typedef std::pair<uint32_t, const LinkBoardSpec*> Item;
+  bool lessItem(const Item & i1, const Item & i2) { return i1.first < i2.first; }
+  bool sameItem(const Item & i1, const Item & i2) { return i1.first == i2.first; }
+
+  /// same file as the open segment (name not re-used by a newer segment)
+  bool sameFile(int fd, const string & path) {
+    struct stat own, named;
+    return fstat(fd, &own) == 0 && stat(path.c_str(), &named) == 0
+        && own.st_dev == named.st_dev && own.st_ino == named.st_ino;
+  }
+}
+
+CablingImage::CablingImage()
+  : theMapped(0), theMappedSize(0), theFd(-1), theHeader(0), theBoards(0), theStrips(0)
+{ }
+
+CablingImage::~CablingImage()
+{
+  reset();
+}
+
+void CablingImage::reset()
+{
+  if (theMapped) munmap(theMapped, theMappedSize);
+  theMapped = 0;
+  theMappedSize = 0;
+  if (theFd >= 0) {
+    // the last user, not blocked by any shared lock, removes the segment
+    if (flock(theFd, LOCK_EX | LOCK_NB) == 0 && sameFile(theFd, theShmDir+theSegment.substr(1))) {
+      shm_unlink(theSegment.c_str());
+    }
+    close(theFd);
+  }
+  theFd = -1;
+  theSegment.clear();
+  vector<char>().swap(thePrivate);
+  theHeader = 0;
+  theBoards = 0;
+  theStrips = 0;
+}
+
+void CablingImage::setPointers(const char * image)
+{
+  theHeader = reinterpret_cast<const Header*>(image);
+  theBoards = reinterpret_cast<const Board*>(image+sizeof(Header));
+  theStrips = reinterpret_cast<const Strip*>(theBoards+theHeader->nBoards);
+}
+
+string CablingImage::version() const
+{
+  return theHeader ? string(theHeader->version) : string();
+}
+
+unsigned int CablingImage::nBoards() const
+{
+  return theHeader ? theHeader->nBoards : 0;
+}
+
+string CablingImage::segmentName(uint64_t mapHash)
+{
+  char name[64];
+  snprintf(name, sizeof(name), "/%s%016llx", theSegmentPrefix, static_cast<unsigned long long>(mapHash));
+  return name;
+}
+
+void CablingImage::removeUnusedSegments()
+{
+  DIR * dir = opendir(theShmDir.c_str());
+  if (!dir) return;
+  while (struct dirent * entry = readdir(dir)) {
+    string file(entry->d_name);
+    if (file.compare(0, sizeof(theSegmentPrefix)-1, theSegmentPrefix) != 0) continue;
+    int fd = shm_open(("/"+file).c_str(), O_RDONLY, 0);
+    if (fd < 0) continue;
+    if (flock(fd, LOCK_EX | LOCK_NB) == 0 && sameFile(fd, theShmDir+file)) {
+      LogTrace("") << "CablingImage: removing unused segment " << file;
+      shm_unlink(("/"+file).c_str());
+    }
+    close(fd);
+  }
+  closedir(dir);
+}
+
+const CablingImage::Board * CablingImage::board(const LinkBoardElectronicIndex & ele) const
+{
+  if (!theHeader) return 0;
+  uint32_t k = key(ele);
+  const Board * end = theBoards+theHeader->nBoards;
+  const Board * ib = lower_bound(theBoards, end, k, lessKey);
+  return (ib != end && ib->key == k) ? ib : 0;
+}
+
+vector<char> CablingImage::build(const RPCReadOutMapping & cabling, uint64_t mapHash)
+{
+  vector<Item> items;
+
+  typedef vector<const DccSpec*> DCCLIST;
+  DCCLIST dccList = cabling.dccList();
+  for (DCCLIST::const_iterator idcc = dccList.begin(); idcc != dccList.end(); ++idcc) {
+    const DccSpec & dccSpec = **idcc;
+    const vector<TriggerBoardSpec> & triggerBoards = dccSpec.triggerBoards();
+    for (vector<TriggerBoardSpec>::const_iterator it = triggerBoards.begin(); it != triggerBoards.end(); ++it) {
+      typedef vector<const LinkConnSpec*> LINKS;
+      LINKS linkConns = it->enabledLinkConns();
+      for (LINKS::const_iterator ic = linkConns.begin(); ic != linkConns.end(); ++ic) {
+        const vector<LinkBoardSpec> & boards = (*ic)->linkBoards();
+        for (vector<LinkBoardSpec>::const_iterator ib = boards.begin(); ib != boards.end(); ++ib) {
+          LinkBoardElectronicIndex eleIndex;
+          eleIndex.dccId = dccSpec.id();
+          eleIndex.dccInputChannelNum = it->dccInputChannelNum();
+          eleIndex.tbLinkInputNum = (*ic)->triggerBoardInputNumber();
+          eleIndex.lbNumInLink = ib->linkBoardNumInLink();
+          items.push_back(Item(key(eleIndex), &(*ib)));
+        }
+      }
+    }
+  }
+  // as in fast search map the first LinkBoard wins if the index is duplicated
+  stable_sort(items.begin(), items.end(), lessItem);
+  items.erase(unique(items.begin(), items.end(), sameItem), items.end());
+
+  uint32_t nBoards = items.size();
+  uint32_t nStrips = nBoards*nStripsInLB;
+  uint32_t size = sizeof(Header) + nBoards*sizeof(Board) + nStrips*sizeof(Strip);
+  vector<char> image(size, 0);
+
+  Header * header = reinterpret_cast<Header*>(&image[0]);
+  memcpy(header->magic, theMagic, sizeof(theMagic));
+  header->size = size;
+  header->nBoards = nBoards;
+  header->nStrips = nStrips;
+  header->mapHash = mapHash;
+  strncpy(header->version, cabling.version().c_str(), sizeof(header->version)-1);
+
+  Board * boards = reinterpret_cast<Board*>(&image[0]+sizeof(Header));
+  Strip * strips = reinterpret_cast<Strip*>(boards+nBoards);
+  for (uint32_t idx = 0; idx < nBoards; ++idx) {
+    boards[idx].key = items[idx].first;
+    boards[idx].firstStrip = idx*nStripsInLB;
+    for (int is = 0; is < nStripsInLB; ++is) {
+      RPCReadOutMapping::StripInDetUnit duFrame =
+          cabling.detUnitFrame(*items[idx].second, LinkBoardPackedStrip(is));
+      strips[idx*nStripsInLB+is].rawDetId = duFrame.first;
+      strips[idx*nStripsInLB+is].strip = duFrame.second;
+    }
+  }
+  header->complete = 1;
+  return image;
+}
+
+bool CablingImage::validImage(const char * image, uint64_t size)
+{
+  if (size < sizeof(Header)) return false;
+  const Header * header = reinterpret_cast<const Header*>(image);
+  if (memcmp(header->magic, theMagic, sizeof(theMagic)) != 0 || !header->complete) return false;
+  if (header->size != size) return false;
+  if (!memchr(header->version, 0, sizeof(header->version))) return false;
+  uint64_t nBoards = header->nBoards;
+  uint64_t nStrips = header->nStrips;
+  if (nStrips != nBoards*nStripsInLB) return false;
+  if (sizeof(Header) + nBoards*sizeof(Board) + nStrips*sizeof(Strip) != size) return false;
+
+  // board() relies on sorted keys, detUnitFrame() on complete strip rows
+  const Board * boards = reinterpret_cast<const Board*>(image+sizeof(Header));
+  for (uint64_t ib = 0; ib < nBoards; ++ib) {
+    if (uint64_t(boards[ib].firstStrip) + nStripsInLB > nStrips) return false;
+    if (ib > 0 && boards[ib].key <= boards[ib-1].key) return false;
+  }
+  return true;
+}
+
+bool CablingImage::attach(uint64_t mapHash)
+{
+  reset();
+  string name = segmentName(mapHash);
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return false;
+
+  // shared lock held while attached, keeps the segment from being removed
+  struct stat st;
+  void * mapped = MAP_FAILED;
+  if (flock(fd, LOCK_SH) == 0 && fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(Header)) ) {
+    mapped = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  if (mapped == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+
+  // only own segments, with consistent geometry, are used
+  const Header * header = static_cast<const Header*>(mapped);
+  bool ok = st.st_uid == geteuid()
+         && validImage(static_cast<const char*>(mapped), st.st_size)
+         && header->mapHash == mapHash;
+  if (!ok) {
+    LogTrace("") << "CablingImage: segment " << name << " not used, foreign or inconsistent";
+    munmap(mapped, st.st_size);
+    close(fd);
+    return false;
+  }
+  theMapped = mapped;
+  theMappedSize = st.st_size;
+  theFd = fd;
+  theSegment = name;
+  setPointers(static_cast<const char*>(mapped));
+  return true;
+}
+
+bool CablingImage::create(const RPCReadOutMapping & cabling, uint64_t mapHash)
+{
+  reset();
+  removeUnusedSegments();
+  vector<char> image = build(cabling, mapHash);
+  string name = segmentName(mapHash);
+
+  //
+  // fill a temporary segment, then publish it under the final name with an atomic
+  // link, so that attach() of other processes never sees a partial image. The
+  // shared lock is taken first: a temporary left by a crash is unlocked and removed
+  // by removeUnusedSegments() of the next creator.
+  //
+  char tmpName[96];
+  snprintf(tmpName, sizeof(tmpName), "%s_tmp_%d", name.c_str(), static_cast<int>(getpid()));
+  shm_unlink(tmpName);
+  int fd = shm_open(tmpName, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd >= 0) {
+    void * mapped = MAP_FAILED;
+    if (flock(fd, LOCK_SH) == 0 && ftruncate(fd, image.size()) == 0) {
+      mapped = mmap(0, image.size(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int published = -1;
+    if (mapped != MAP_FAILED) {
+      memcpy(mapped, &image[0], image.size());
+      mprotect(mapped, image.size(), PROT_READ);
+      published = link((theShmDir+(tmpName+1)).c_str(), (theShmDir+name.substr(1)).c_str());
+    }
+    int linkErrno = errno;
+    shm_unlink(tmpName);
+    if (published == 0) {
+      theMapped = mapped;
+      theMappedSize = image.size();
+      theFd = fd;
+      theSegment = name;
+      setPointers(static_cast<const char*>(mapped));
+      return true;
+    }
+    if (mapped != MAP_FAILED) munmap(mapped, image.size());
+    close(fd);
+    if (linkErrno == EEXIST && attach(mapHash)) return true;
+    LogTrace("") << "CablingImage: can not publish shared segment " << name << ", errno: " << linkErrno;
+  }
+
+  //
+  // no shared memory: keep private copy
+  //
+  LogTrace("") << "CablingImage: using private image for version " << cabling.version();
+  thePrivate.swap(image);
+  setPointers(&thePrivate[0]);
+  return false;
+}
+
+void CablingImage::createPrivate(const RPCReadOutMapping & cabling)
+{
+  reset();
+  vector<char> image = build(cabling, 0);
+  thePrivate.swap(image);
+  setPointers(&thePrivate[0]);
+}
@@ -0,0 +1,30 @@
+#include "EventFilter/RPCRawToDigi/interface/RPCDigiSoA.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void RPCDigiSoA::fill(vector<uint64_t> & packedHits)
+{
+  sort(packedHits.begin(), packedHits.end());
+
+  unsigned int nHits = packedHits.size();
+  theRawDetIds.resize(nHits);
+  theStrips.resize(nHits);
+  theBXs.resize(nHits);
+  theChambers.clear();
+  theOffsets.clear();
+
+  for (unsigned int ih = 0; ih < nHits; ++ih) {
+    uint64_t hit = packedHits[ih];
+    uint32_t rawDetId = hit >> 32;
+    theRawDetIds[ih] = rawDetId;
+    theStrips[ih] = (hit >> 16) & 0xFFFF;
+    theBXs[ih] = int(hit & 0xFFFF) - 0x8000;
+    if (theChambers.empty() || theChambers.back() != rawDetId) {
+      theChambers.push_back(rawDetId);
+      theOffsets.push_back(ih);
+    }
+  }
+  theOffsets.push_back(nHits);
+}
@@ -0,0 +1,49 @@
+#include "EventFilter/RPCRawToDigi/interface/RPCEMapHash.h"
+
+using namespace rpcrawtodigi;
+using namespace std;
+
+void RPCEMapHash::add(const RPCEMap::linkItem & link)
+{
+  add(link.theTriggerBoardInputNumber);
+  add(link.nLBs);
+}
+
+void RPCEMapHash::add(const RPCEMap::lbItem & lb)
+{
+  add(int(lb.theMaster));
+  add(lb.theLinkBoardNumInLink);
+  add(lb.theCode);
+  add(lb.nFebs);
+}
+
+void RPCEMapHash::add(const RPCEMap::febItem & feb)
+{
+  add(feb.theLinkBoardInputNum);
+  add(feb.thePartition);
+  add(feb.theChamber);
+  add(feb.theAlgo);
+}
+
+uint64_t RPCEMapHash::map(const RPCEMap & map)
+{
+  RPCEMapHash hash;
+  hash.add(map.theVersion.data(), map.theVersion.size());
+  hash.add(int(map.theDccs.size()));
+  for (vector<RPCEMap::dccItem>::const_iterator it = map.theDccs.begin(); it != map.theDccs.end(); ++it) {
+    hash.add(it->theId);
+    hash.add(it->nTBs);
+  }
+  hash.add(int(map.theTBs.size()));
+  for (vector<RPCEMap::tbItem>::const_iterator it = map.theTBs.begin(); it != map.theTBs.end(); ++it) {
+    hash.add(it->theNum);
+    hash.add(it->nLinks);
+  }
+  hash.add(int(map.theLinks.size()));
+  for (vector<RPCEMap::linkItem>::const_iterator it = map.theLinks.begin(); it != map.theLinks.end(); ++it) hash.add(*it);
+  hash.add(int(map.theLBs.size()));
+  for (vector<RPCEMap::lbItem>::const_iterator it = map.theLBs.begin(); it != map.theLBs.end(); ++it) hash.add(*it);
+  hash.add(int(map.theFebs.size()));
+  for (vector<RPCEMap::febItem>::const_iterator it = map.theFebs.begin(); it != map.theFebs.end(); ++it) hash.add(*it);
+  return hash.value();
+}
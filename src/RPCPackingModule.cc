@@ -20,10 +20,14 @@
 
 #include "EventFilter/RPCRawToDigi/interface/RPCRecordFormatter.h"
 #include "EventFilter/RPCRawToDigi/interface/DebugDigisPrintout.h"
+#include "EventFilter/RPCRawToDigi/interface/FedCrc.h"
 #include "DataFormats/RPCDigi/interface/EmptyWord.h"
 
+#include "tbb/parallel_for.h"
+
 #include <string>
 #include <sstream>
+#include <algorithm>
 
 
 using namespace std;
@@ -34,6 +38,8 @@ typedef uint64_t Word64;
 
 RPCPackingModule::RPCPackingModule( const ParameterSet& pset ) 
   : dataLabel_(pset.getParameter<edm::InputTag>("InputLabel")),
+    parallelFEDs_(pset.getUntrackedParameter<bool>("parallelFEDs",true)),
+    densePacking_(pset.getUntrackedParameter<bool>("densePacking",false)),
     eventCounter_(0)
 {
   
@@ -59,8 +65,7 @@ void RPCPackingModule::produce( edm::Event& ev,
   ev.getByLabel(dataLabel_,digiCollection);
   LogDebug("") << DebugDigisPrintout()(digiCollection.product());
 
-  static edm::ESWatcher<RPCEMapRcd> recordWatcher; 
-  if(recordWatcher.check(es)) {
+  if(recordWatcher_.check(es)) {
     delete theCabling;
     LogTrace("") << "record has CHANGED!!, initialise readout map!";
     ESHandle<RPCEMap> readoutMapping;
@@ -73,15 +78,24 @@ void RPCPackingModule::produce( edm::Event& ev,
 
 //  pair<int,int> rpcFEDS=FEDNumbering::getRPCFEDIds();
   pair<int,int> rpcFEDS(790,792);
-  for (int id= rpcFEDS.first; id<=rpcFEDS.second; ++id){
+  unsigned int lvl1_ID = ev.id().event();
+  const RPCDigiCollection * digis = digiCollection.product();
 
+  //
+  // FED payloads are independent, each task fills its own slot of the collection
+  //
+  auto packFED = [&](int id) {
     RPCRecordFormatter formatter(id, theCabling) ;
-    unsigned int lvl1_ID = ev.id().event();
-    FEDRawData* rawData =  RPCPackingModule::rawData(id, lvl1_ID, digiCollection.product(), formatter);
+    FEDRawData* rawData =  RPCPackingModule::rawData(id, lvl1_ID, digis, formatter);
     FEDRawData& fedRawData = buffers->FEDData(id);
 
     fedRawData = *rawData;
     delete rawData;
+  };
+  if (parallelFEDs_) {
+    tbb::parallel_for(rpcFEDS.first, rpcFEDS.second+1, packFED);
+  } else {
+    for (int id= rpcFEDS.first; id<=rpcFEDS.second; ++id) packFED(id);
   }
   ev.put( buffers );  
 }
@@ -98,15 +112,29 @@ FEDRawData * RPCPackingModule::rawData( int fedId, unsigned int lvl1_ID, const R
   //
   // create data words
   //
+  vector<Word64> dataWords = densePacking_ ?
+      RPCPackingModule::denseDataWords(merged) : RPCPackingModule::dataWords(merged);
+
+  return RPCPackingModule::fedRawData(fedId, lvl1_ID, trigger_BX, dataWords);
+}
+
+vector<Word64> RPCPackingModule::dataWords(const vector<EventRecords> & records)
+{
   vector<Word64> dataWords;
+  dataWords.reserve(records.size());
   EmptyWord empty;
   typedef vector<EventRecords>::const_iterator IR;
-  for (IR ir = merged.begin(), irEnd =  merged.end() ; ir != irEnd; ++ir) {
+  for (IR ir = records.begin(), irEnd =  records.end() ; ir != irEnd; ++ir) {
     Word64 w = ( ( (Word64(ir->recordBX().data()) << 16) | ir->recordSLD().data() ) << 16
                     | ir->recordCD().data() ) << 16 | empty.data();
     dataWords.push_back(w);
   }
+  return dataWords;
+}
 
+FEDRawData * RPCPackingModule::fedRawData( int fedId, unsigned int lvl1_ID, int trigger_BX,
+                                           const vector<Word64> & dataWords)
+{
   //
   // create raw data
   //
@@ -140,10 +168,52 @@ FEDRawData * RPCPackingModule::rawData( int fedId, unsigned int lvl1_ID, const R
   int tts = 0;
   int datasize =  raw->size()/sizeof(Word64);
   FEDTrailer::set(pTrailer, datasize, crc, evt_stat, tts);
+  crc = FedCrc::compute(reinterpret_cast<const Word64*>(pHeader), datasize);
+  FEDTrailer::set(pTrailer, datasize, crc, evt_stat, tts);
 
   return raw;
 }
 
+namespace {
+  bool lessBxLink(const EventRecords & r1, const EventRecords & r2) {
+    if (r1.recordBX().data() != r2.recordBX().data()) return r1.recordBX().data() < r2.recordBX().data();
+    return r1.recordSLD().data() < r2.recordSLD().data();
+  }
+}
+
+vector<Word64> RPCPackingModule::denseDataWords(vector<EventRecords> & records)
+{
+  //
+  // group records by BX and link, then write BX and SLD records only when
+  // they change. The unpacker keeps BX and SLD state between records, but a
+  // new BX record invalidates the link, so SLD is repeated after each BX.
+  //
+  stable_sort(records.begin(), records.end(), lessBxLink);
+
+  vector<DataRecord::Data> stream;
+  stream.reserve(3*records.size());
+  typedef vector<EventRecords>::const_iterator IR;
+  for (IR ir = records.begin(), irEnd = records.end(); ir != irEnd; ++ir) {
+    bool newBX = (ir == records.begin() || ir->recordBX().data() != (ir-1)->recordBX().data());
+    if (newBX) stream.push_back(ir->recordBX().data());
+    if (newBX || ir->recordSLD().data() != (ir-1)->recordSLD().data()) stream.push_back(ir->recordSLD().data());
+    stream.push_back(ir->recordCD().data());
+  }
+  EmptyWord empty;
+  while (stream.size()%4) stream.push_back(empty.data());
+
+  //
+  // 4 records per word, first record in the most significant bits
+  //
+  vector<Word64> dataWords;
+  dataWords.reserve(stream.size()/4);
+  for (unsigned int is = 0; is < stream.size(); is += 4) {
+    dataWords.push_back( (Word64(stream[is]) << 48) | (Word64(stream[is+1]) << 32)
+                       | (Word64(stream[is+2]) << 16) | Word64(stream[is+3]) );
+  }
+  return dataWords;
+}
+
 vector<EventRecords> RPCPackingModule::eventRecords(
     int fedId, 
     int trigger_BX, 
@@ -0,0 +1,104 @@
+#include "EventFilter/RPCRawToDigi/interface/RPCRawSynchroHistogram.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkBoardKey.h"
+#include "DataFormats/FEDRawData/interface/FEDNumbering.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+using namespace rpcrawtodigi;
+
+namespace {
+  // LinkBoard index ranges of the dense accumulator, as in RecordSLD/RecordCD bit fields
+  const int nRMBs = 64;
+  const int nLinks = 32;
+  const int nLBs = 4;
+  const int nDCCs = FEDNumbering::MAXRPCFEDID - FEDNumbering::MINRPCFEDID + 1;
+}
+
+const uint32_t * RPCRawSynchroHistogram::counts(const LinkBoardElectronicIndex & ele) const
+{
+  uint32_t key = linkBoardKey(ele);
+  vector<uint32_t>::const_iterator il = lower_bound(theLinks.begin(), theLinks.end(), key);
+  if (il == theLinks.end() || *il != key) return 0;
+  return &theCounts[(il-theLinks.begin())*nDelays];
+}
+
+bool RPCRawSynchroHistogram::mergeProduct(const RPCRawSynchroHistogram & o)
+{
+  RPCRawSynchroHistogram sum;
+  unsigned int i1 = 0, i2 = 0;
+  while (i1 < size() || i2 < o.size()) {
+    if (i2 == o.size() || (i1 < size() && link(i1) < o.link(i2))) {
+      sum.push_back(link(i1), counts(i1));
+      ++i1;
+    } else if (i1 == size() || o.link(i2) < link(i1)) {
+      sum.push_back(o.link(i2), o.counts(i2));
+      ++i2;
+    } else {
+      uint32_t c[nDelays];
+      for (int id = 0; id < nDelays; ++id) c[id] = counts(i1)[id] + o.counts(i2)[id];
+      sum.push_back(link(i1), c);
+      ++i1;
+      ++i2;
+    }
+  }
+  sum.theOutOfRange = theOutOfRange + o.theOutOfRange;
+  swap(theLinks, sum.theLinks);
+  swap(theCounts, sum.theCounts);
+  theOutOfRange = sum.theOutOfRange;
+  return true;
+}
+
+string RPCRawSynchroHistogram::print() const
+{
+  ostringstream str;
+  for (unsigned int idx = 0; idx < size(); ++idx) {
+    LinkBoardElectronicIndex ele = linkBoardIndex(link(idx));
+    str << "dcc: " << ele.dccId << " rmb: " << ele.dccInputChannelNum
+        << " lnk: " << ele.tbLinkInputNum << " lb: " << ele.lbNumInLink << " delays:";
+    for (int id = 0; id < nDelays; ++id) str << " " << counts(idx)[id];
+    str << endl;
+  }
+  str << "out of range: " << theOutOfRange << endl;
+  return str.str();
+}
+
+SynchroAccumulator::SynchroAccumulator()
+  : theCounts(nDCCs*nRMBs*nLinks*nLBs*RPCRawSynchroHistogram::nDelays, 0), theOutOfRange(0)
+{ }
+
+int SynchroAccumulator::index(const LinkBoardElectronicIndex & ele)
+{
+  int dcc = ele.dccId - FEDNumbering::MINRPCFEDID;
+  if (dcc < 0 || dcc >= nDCCs
+      || ele.dccInputChannelNum < 0 || ele.dccInputChannelNum >= nRMBs
+      || ele.tbLinkInputNum < 0 || ele.tbLinkInputNum >= nLinks
+      || ele.lbNumInLink < 0 || ele.lbNumInLink >= nLBs) return -1;
+  return ((dcc*nRMBs + ele.dccInputChannelNum)*nLinks + ele.tbLinkInputNum)*nLBs + ele.lbNumInLink;
+}
+
+void SynchroAccumulator::fillHistogram(RPCRawSynchroHistogram & histo) const
+{
+  const int nDelays = RPCRawSynchroHistogram::nDelays;
+  int nIndexes = theCounts.size()/nDelays;
+  for (int idx = 0; idx < nIndexes; ++idx) {
+    const uint32_t * c = &theCounts[idx*nDelays];
+    bool empty = true;
+    for (int id = 0; id < nDelays; ++id) if (c[id]) empty = false;
+    if (empty) continue;
+    LinkBoardElectronicIndex ele;
+    ele.lbNumInLink = idx % nLBs;
+    ele.tbLinkInputNum = (idx / nLBs) % nLinks;
+    ele.dccInputChannelNum = (idx / (nLBs*nLinks)) % nRMBs;
+    ele.dccId = idx / (nLBs*nLinks*nRMBs) + FEDNumbering::MINRPCFEDID;
+    histo.push_back(linkBoardKey(ele), c);
+  }
+  histo.addOutOfRange(theOutOfRange);
+}
+
+void SynchroAccumulator::clear()
+{
+  std::fill(theCounts.begin(), theCounts.end(), 0);
+  theOutOfRange = 0;
+}
@@ -8,6 +8,10 @@
  */
 
 #include "EventFilter/RPCRawToDigi/interface/RPCRecordFormatter.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCCablingImage.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCDigiSoA.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCRawSynchroHistogram.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCStripMask.h"
 
 #include "DataFormats/MuonDetId/interface/RPCDetId.h"
 #include "DataFormats/RPCDigi/interface/RPCDigi.h"
@@ -31,7 +35,18 @@ using namespace rpcrawtodigi;
 
 
 RPCRecordFormatter::RPCRecordFormatter(int fedId, const RPCReadOutMapping *r)
- : currentFED(fedId), readoutMapping(r)
+ : currentFED(fedId), readoutMapping(r), cablingImage(0), instrumentation(0), packedDigis(0), synchroAccumulator(0),
+   maskedLocation(0)
+{ }
+
+RPCRecordFormatter::RPCRecordFormatter(int fedId, const CablingImage *image)
+ : currentFED(fedId), readoutMapping(0), cablingImage(image), instrumentation(0), packedDigis(0), synchroAccumulator(0),
+   maskedLocation(0)
+{ }
+
+RPCRecordFormatter::RPCRecordFormatter(int fedId, const MaskedLocation *location)
+ : currentFED(fedId), readoutMapping(0), cablingImage(0), instrumentation(0), packedDigis(0), synchroAccumulator(0),
+   maskedLocation(location)
 { }
 
 RPCRecordFormatter::~RPCRecordFormatter()
@@ -91,9 +106,6 @@ int RPCRecordFormatter::recordUnpack(
     const EventRecords & event, 
     RPCDigiCollection * prod, RPCRawDataCounts * counter, RPCRawSynchro::ProdItem * synchro)
 {
-
-  static bool debug = edm::MessageDrop::instance()->debugEnabled;
-  ReadoutError error;
   int currentRMB = event.recordSLD().rmb(); 
   int currentTbLinkInputNumber = event.recordSLD().tbLinkInputNumber();
 
@@ -108,49 +120,94 @@ int RPCRecordFormatter::recordUnpack(
      if(counter) counter->addReadoutError(currentFED, ReadoutError(eleIndex,ReadoutError::EOD));
   }
 
-  if(readoutMapping == 0) return error.type();
-  const LinkBoardSpec* linkBoard = readoutMapping->location(eleIndex);
-  if (!linkBoard) {
+  return linkUnpack(eleIndex, event.recordCD().partitionNumber(), event.recordCD().partitionData(),
+                    event.dataToTriggerDelay(), prod, counter, synchro);
+}
+
+int RPCRecordFormatter::linkHitUnpack(
+    const LinkHit & hit,
+    RPCDigiCollection * prod, RPCRawDataCounts * counter, RPCRawSynchro::ProdItem * synchro)
+{
+  LinkBoardElectronicIndex eleIndex = hit.electronicIndex();
+  if (hit.eod) {
+     if(counter) counter->addReadoutError(hit.dccId, ReadoutError(eleIndex,ReadoutError::EOD));
+  }
+  return linkUnpack(eleIndex, hit.partition, hit.data, hit.delay, prod, counter, synchro);
+}
+
+int RPCRecordFormatter::linkUnpack(
+    const LinkBoardElectronicIndex & eleIndex, int partitionNumber, int partitionData, int delay,
+    RPCDigiCollection * prod, RPCRawDataCounts * counter, RPCRawSynchro::ProdItem * synchro)
+{
+  static bool debug = edm::MessageDrop::instance()->debugEnabled;
+  ReadoutError error;
+  int dccId = eleIndex.dccId;
+
+  if(readoutMapping == 0 && cablingImage == 0 && maskedLocation == 0) return error.type();
+  const LinkBoardSpec* linkBoard = 0;
+  const CablingImage::Board * imageBoard = 0;
+  const RPCReadOutMapping::StripInDetUnit * lbStrips = 0;
+  const StripMask * mask = 0;
+  if (cablingImage) imageBoard = cablingImage->board(eleIndex);
+  else if (maskedLocation) lbStrips = maskedLocation->strips(eleIndex, mask);
+  else linkBoard = readoutMapping->location(eleIndex);
+  if (instrumentation) instrumentation->lookups++;
+  if (!linkBoard && !imageBoard && !lbStrips) {
+    if (instrumentation) instrumentation->lookupMisses++;
     if (debug) LogDebug("")<<" ** PROBLEM ** Invalid Linkboard location, skip CD event, " 
               << "dccId: "<<eleIndex.dccId
               << "dccInputChannelNum: " <<eleIndex.dccInputChannelNum
               << " tbLinkInputNum: "<<eleIndex.tbLinkInputNum
               << " lbNumInLink: "<<eleIndex.lbNumInLink;
     error = ReadoutError(eleIndex,ReadoutError::InvalidLB);
-    if(counter) counter->addReadoutError(currentFED,error );
+    if(counter) counter->addReadoutError(dccId,error );
     return error.type();
   }
 
 
-  std::vector<int> packStrips = event.recordCD().packedStrips();
-  if (packStrips.size() ==0) {
+  // packed strips expanded in place (as RecordCD::packedStrips()) to avoid per record allocation
+  if (partitionData == 0) {
     error = ReadoutError(eleIndex,ReadoutError::EmptyPackedStrips);
-    if(counter) counter->addReadoutError(currentFED, error);
+    if(counter) counter->addReadoutError(dccId, error);
     return error.type();
   }
 
-  for(std::vector<int>::iterator is = packStrips.begin(); is != packStrips.end(); ++is) {
+  // masked and dead strips dropped here, not in a later pass over the digis
+  if (mask) {
+    int masked = mask->masked(partitionNumber, partitionData);
+    if (masked) {
+      partitionData &= ~masked;
+      if (instrumentation) instrumentation->maskedHits += bitset<8>(masked).count();
+    }
+  }
+
+  for (int ib = 0; ib < 8; ++ib) {
+    if ( !(partitionData >> ib & 1) ) continue;
+    int packedStrip = partitionNumber*8 + ib;
 
-    RPCReadOutMapping::StripInDetUnit duFrame = 
-        readoutMapping->detUnitFrame(*linkBoard, LinkBoardPackedStrip(*is) );
+    RPCReadOutMapping::StripInDetUnit duFrame;
+    if (imageBoard) duFrame = cablingImage->detUnitFrame(*imageBoard, packedStrip);
+    else if (lbStrips) duFrame = packedStrip < MaskedLocation::nStripsInLB ?
+        lbStrips[packedStrip] : RPCReadOutMapping::StripInDetUnit(0,0);
+    else duFrame = readoutMapping->detUnitFrame(*linkBoard, LinkBoardPackedStrip(packedStrip) );
 
     uint32_t rawDetId = duFrame.first;
     int geomStrip = duFrame.second;
     if (!rawDetId) {
       if (debug) LogTrace("") << " ** PROBLEM ** no rawDetId, skip at least part of CD data";
       error = ReadoutError(eleIndex,ReadoutError::InvalidDetId);
-      if (counter) counter->addReadoutError(currentFED, error);
+      if (counter) counter->addReadoutError(dccId, error);
       continue;
     }
     if (geomStrip==0) {
       if(debug) LogTrace("") <<" ** PROBLEM ** no strip found";
       error = ReadoutError(eleIndex,ReadoutError::InvalidStrip);
-      if (counter) counter->addReadoutError(currentFED, error);
+      if (counter) counter->addReadoutError(dccId, error);
       continue;
     }
 
     // Creating RPC digi
-    RPCDigi digi(geomStrip,event.dataToTriggerDelay()-3);
+    RPCDigi digi(geomStrip,delay-3);
 
     /// Committing digi to the product
     if (debug) {
@@ -158,6 +215,8 @@ int RPCRecordFormatter::recordUnpack(
       LogTrace("")<<" DIGI;  det: "<<rawDetId<<", strip: "<<digi.strip()<<", bx: "<<digi.bx();
     }
     if (prod) prod->insertDigi(RPCDetId(rawDetId),digi);
+    if (packedDigis) packedDigis->push_back(RPCDigiSoA::pack(rawDetId, geomStrip, digi.bx()));
+    if (instrumentation) instrumentation->digis++;
 
 //    if (RPCDetId(rawDetId).region() == -1 ) {
 //       RPCDetId det(rawDetId);
@@ -169,7 +228,8 @@ int RPCRecordFormatter::recordUnpack(
 
   }
 
-  if(synchro) synchro->push_back( make_pair(eleIndex,event.dataToTriggerDelay() ));
+  if(synchro) synchro->push_back( make_pair(eleIndex,delay ));
+  if(synchroAccumulator) synchroAccumulator->fill(eleIndex, delay);
 
   return error.type();
 }
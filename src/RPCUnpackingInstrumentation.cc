@@ -0,0 +1,68 @@
+#include "EventFilter/RPCRawToDigi/interface/RPCUnpackingInstrumentation.h"
+
+#include <sstream>
+#include <iomanip>
+
+using namespace std;
+
+RPCUnpackingInstrumentation::FedItem::FedItem(int fed)
+  : fedId(fed), events(0), words(0), cdRecords(0), digis(0), lookups(0), lookupMisses(0),
+    cacheHits(0), maskedHits(0), crcMismatches(0),
+    wallHeaders(0), cpuHeaders(0), wallRecords(0), cpuRecords(0), wallMapping(0)
+{
+  for (unsigned int i=0; i<nRecordTypes; ++i) records[i] = 0;
+}
+
+void RPCUnpackingInstrumentation::FedItem::add(const FedItem & o)
+{
+  events += o.events;
+  words += o.words;
+  for (unsigned int i=0; i<nRecordTypes; ++i) records[i] += o.records[i];
+  cdRecords += o.cdRecords;
+  digis += o.digis;
+  lookups += o.lookups;
+  lookupMisses += o.lookupMisses;
+  cacheHits += o.cacheHits;
+  maskedHits += o.maskedHits;
+  crcMismatches += o.crcMismatches;
+  wallHeaders += o.wallHeaders;
+  cpuHeaders += o.cpuHeaders;
+  wallRecords += o.wallRecords;
+  cpuRecords += o.cpuRecords;
+  wallMapping += o.wallMapping;
+}
+
+RPCUnpackingInstrumentation::FedItem & RPCUnpackingInstrumentation::fed(int fedId)
+{
+  for (vector<FedItem>::iterator it = theFeds.begin(); it != theFeds.end(); ++it) {
+    if (it->fedId == fedId) return *it;
+  }
+  theFeds.push_back(FedItem(fedId));
+  return theFeds.back();
+}
+
+void RPCUnpackingInstrumentation::add(const RPCUnpackingInstrumentation & o)
+{
+  for (vector<FedItem>::const_iterator it = o.theFeds.begin(); it != o.theFeds.end(); ++it) {
+    fed(it->fedId).add(*it);
+  }
+}
+
+string RPCUnpackingInstrumentation::print() const
+{
+  ostringstream str;
+  str << "  fed     events      words  cdRecords      digis    lookups     misses  cacheHits     masked  crcErrors"
+      << "   hdr[us/ev]   rec[us/ev] (wall / cpu)   map[us/ev] (wall, sampled)" << endl;
+  for (vector<FedItem>::const_iterator it = theFeds.begin(); it != theFeds.end(); ++it) {
+    double n = it->events ? 1000.*it->events : 1.;
+    str << setw(5) << it->fedId
+        << setw(11) << it->events << setw(11) << it->words << setw(11) << it->cdRecords
+        << setw(11) << it->digis << setw(11) << it->lookups << setw(11) << it->lookupMisses
+        << setw(11) << it->cacheHits << setw(11) << it->maskedHits << setw(11) << it->crcMismatches
+        << fixed << setprecision(2)
+        << setw(7) << it->wallHeaders/n << "/" << setw(5) << it->cpuHeaders/n
+        << setw(7) << it->wallRecords/n << "/" << setw(5) << it->cpuRecords/n
+        << setw(10) << it->wallMapping/n << endl;
+  }
+  return str.str();
+}
@@ -0,0 +1,18 @@
+#include "DataFormats/Common/interface/Wrapper.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCUnpackingInstrumentation.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCDigiSoA.h"
+#include "EventFilter/RPCRawToDigi/interface/RPCRawSynchroHistogram.h"
+#include "EventFilter/RPCRawToDigi/interface/LinkHit.h"
+
+namespace {
+  struct dictionary {
+    RPCUnpackingInstrumentation ui;
+    edm::Wrapper<RPCUnpackingInstrumentation> wui;
+    RPCDigiSoA ds;
+    edm::Wrapper<RPCDigiSoA> wds;
+    RPCRawSynchroHistogram sh;
+    edm::Wrapper<RPCRawSynchroHistogram> wsh;
+    RPCLinkHitCollection lh;
+    edm::Wrapper<RPCLinkHitCollection> wlh;
+  };
+}
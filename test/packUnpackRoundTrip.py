@@ -0,0 +1,74 @@
+import FWCore.ParameterSet.Config as cms
+
+#
+# pack -> unpack round trip of RPC digis, with sparse and with dense packing.
+# Reference digis are unpacked from synthetic raw data (no error records or
+# faults), packed again by rpcpacker and unpacked; both round trips are
+# compared with the reference by RPCDigiComparisonAnalyzer, no mismatch is
+# expected in the summaries at the end of job.
+# The same raw data unpacked in chunks (parallelChunkRecords) is compared with
+# the serial reference as well. Repeated raw data (same payload in every
+# event) is unpacked with and without unpackCacheSize, such that all events
+# but the first are taken from the cache, and the two are compared. Digis
+# re-mapped from link hits by rpcLinkHitsToDigi are compared with the
+# reference too.
+#
+process = cms.Process("RPCPACKUNPACK")
+
+process.load("EventFilter.RPCRawToDigi.RPCSQLiteCabling_cfi")
+process.RPCCabling.connect = 'sqlite_file:RPCEMap3.db'
+
+process.load("EventFilter.RPCRawToDigi.rpcSyntheticRawData_cfi")
+process.rpcSyntheticRawData.noiseRate = 0.01
+process.rpcSyntheticRawDataRepeated = process.rpcSyntheticRawData.clone(repeatEvent = True)
+
+process.load("EventFilter.RPCRawToDigi.rpcUnpacker_cfi")
+process.rpcunpacker.InputLabel = cms.InputTag("rpcSyntheticRawData")
+process.rpcunpacker.checkCrc = True
+process.rpcunpacker.checkIncrementalCabling = True
+
+process.load("EventFilter.RPCRawToDigi.rpcPacker_cfi")
+process.rpcpacker.InputLabel = cms.InputTag("rpcunpacker")
+process.rpcpacker.densePacking = False
+process.rpcpackerDense = process.rpcpacker.clone(densePacking = True)
+
+process.rpcunpackerSparse = process.rpcunpacker.clone(InputLabel = cms.InputTag("rpcpacker"))
+process.rpcunpackerDense = process.rpcunpacker.clone(InputLabel = cms.InputTag("rpcpackerDense"))
+
+# small chunks, such that FEDs are split in several chunks
+process.rpcunpackerChunked = process.rpcunpacker.clone(parallelChunkRecords = 8)
+
+process.rpcunpackerRepeated = process.rpcunpacker.clone(InputLabel = cms.InputTag("rpcSyntheticRawDataRepeated"))
+process.rpcunpackerCached = process.rpcunpackerRepeated.clone(unpackCacheSize = 16)
+
+process.rpcunpackerLinkHits = process.rpcunpacker.clone(doLinkHits = True)
+process.load("EventFilter.RPCRawToDigi.rpcLinkHitsToDigi_cfi")
+process.rpcLinkHitsToDigi.InputLabel = cms.InputTag("rpcunpackerLinkHits")
+
+process.load("EventFilter.RPCRawToDigi.rpcDigiComparison_cfi")
+process.rpcDigiComparison.firstLabel = cms.InputTag("rpcunpacker")
+process.rpcDigiComparison.secondLabel = cms.InputTag("rpcunpackerSparse")
+process.rpcDigiComparisonDense = process.rpcDigiComparison.clone(secondLabel = cms.InputTag("rpcunpackerDense"))
+process.rpcDigiComparisonChunked = process.rpcDigiComparison.clone(secondLabel = cms.InputTag("rpcunpackerChunked"))
+process.rpcDigiComparisonCached = process.rpcDigiComparison.clone(firstLabel = cms.InputTag("rpcunpackerRepeated"),
+    secondLabel = cms.InputTag("rpcunpackerCached"))
+process.rpcDigiComparisonLinkHits = process.rpcDigiComparison.clone(secondLabel = cms.InputTag("rpcLinkHitsToDigi"))
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(100))
+process.source = cms.Source("EmptySource")
+
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring('cout'),
+    cout = cms.untracked.PSet( threshold = cms.untracked.string('INFO'))
+)
+
+process.p = cms.Path(process.rpcSyntheticRawData*process.rpcunpacker
+    *process.rpcpacker*process.rpcunpackerSparse
+    *process.rpcpackerDense*process.rpcunpackerDense
+    *process.rpcunpackerChunked
+    *process.rpcSyntheticRawDataRepeated*process.rpcunpackerRepeated*process.rpcunpackerCached
+    *process.rpcunpackerLinkHits*process.rpcLinkHitsToDigi)
+process.e = cms.EndPath(process.rpcDigiComparison*process.rpcDigiComparisonDense
+    *process.rpcDigiComparisonChunked*process.rpcDigiComparisonCached
+    *process.rpcDigiComparisonLinkHits)
@@ -0,0 +1,31 @@
+import FWCore.ParameterSet.Config as cms
+
+#
+# unpacker throughput on synthetic raw data: change noiseRate (occupancy)
+# and error rates, compare timing summaries at the end of job
+#
+process = cms.Process("RPCSYNTHR2D")
+
+process.load("EventFilter.RPCRawToDigi.RPCSQLiteCabling_cfi")
+process.RPCCabling.connect = 'sqlite_file:RPCEMap3.db'
+
+process.load("EventFilter.RPCRawToDigi.rpcSyntheticRawData_cfi")
+process.rpcSyntheticRawData.noiseRate = 0.01
+process.rpcSyntheticRawData.errorRecordRate = 0.001
+
+process.load("EventFilter.RPCRawToDigi.rpcUnpacker_cfi")
+process.rpcunpacker.InputLabel = cms.InputTag("rpcSyntheticRawData")
+process.rpcunpacker.doInstrumentation = True
+process.rpcunpacker.checkCrc = True
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(1000))
+process.source = cms.Source("EmptySource")
+
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring('cout'),
+    cout = cms.untracked.PSet( threshold = cms.untracked.string('INFO'))
+)
+process.Timing = cms.Service("Timing", summaryOnly = cms.untracked.bool(True))
+
+process.p = cms.Path(process.rpcSyntheticRawData*process.rpcunpacker)
@@ -0,0 +1,78 @@
+/*
+ * FedCrc (table driven, slice-by-8) compared with a bit serial reference of
+ * the slink CRC-16: polynomial 0x8005, initial value 0xFFFF, no reflection,
+ * no final xor, bits of each 64 bit word from the most significant one, CRC
+ * field of the trailer taken as zero. The reference itself is checked with
+ * the catalogued check value of this CRC (CRC-16/CMS, "123456789" -> 0xAEE7).
+ */
+
+#include "EventFilter/RPCRawToDigi/interface/FedCrc.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <stdint.h>
+
+using namespace std;
+using rpcrawtodigi::FedCrc;
+
+namespace {
+  uint16_t referenceBit(uint16_t crc, bool bit) {
+    bool feedback = ((crc >> 15) & 1) != bit;
+    crc <<= 1;
+    return feedback ? crc ^ 0x8005 : crc;
+  }
+
+  uint16_t referenceBytes(const unsigned char * data, unsigned int nBytes) {
+    uint16_t crc = 0xFFFF;
+    for (unsigned int ib = 0; ib < nBytes; ++ib) {
+      for (int bit = 7; bit >= 0; --bit) crc = referenceBit(crc, (data[ib] >> bit) & 1);
+    }
+    return crc;
+  }
+
+  uint16_t referenceWords(const vector<uint64_t> & words) {
+    uint16_t crc = 0xFFFF;
+    for (unsigned int iw = 0; iw < words.size(); ++iw) {
+      uint64_t w = words[iw];
+      if (iw == words.size()-1) w &= ~FedCrc::trailerCrcMask;
+      for (int bit = 63; bit >= 0; --bit) crc = referenceBit(crc, (w >> bit) & 1);
+    }
+    return crc;
+  }
+}
+
+int main()
+{
+  int nFailed = 0;
+
+  const unsigned char check[] = "123456789";
+  if (referenceBytes(check, 9) != 0xAEE7) {
+    cout << "reference CRC of check string: " << hex << referenceBytes(check, 9) << " expected aee7" << endl;
+    ++nFailed;
+  }
+
+  mt19937_64 engine(12345);
+  for (unsigned int nWords = 1; nWords <= 2048; nWords = nWords < 16 ? nWords+1 : 2*nWords) {
+    for (int iTry = 0; iTry < 16; ++iTry) {
+      vector<uint64_t> words(nWords);
+      for (unsigned int iw = 0; iw < nWords; ++iw) words[iw] = engine();
+      uint16_t expected = referenceWords(words);
+      uint16_t computed = FedCrc::compute(&words[0], nWords);
+      if (computed != expected) {
+        cout << "nWords: " << dec << nWords << " FedCrc: " << hex << computed << " reference: " << expected << endl;
+        ++nFailed;
+      }
+      // CRC field of the trailer does not enter
+      words.back() ^= FedCrc::trailerCrcMask;
+      if (FedCrc::compute(&words[0], nWords) != computed) {
+        cout << "nWords: " << dec << nWords << " CRC depends on trailer CRC field" << endl;
+        ++nFailed;
+      }
+    }
+  }
+
+  if (nFailed) cout << dec << nFailed << " FedCrc checks failed" << endl;
+  else cout << "FedCrc agrees with bit serial reference" << endl;
+  return nFailed ? 1 : 0;
+}